@@ -0,0 +1,212 @@
+/*
+ * ECEE 2160 Homework assignment 1 fixed-size matrix.
+ *
+ * All of the member functions of FixedMatrix are templated and constexpr, so
+ * no implementation (.cpp) file is required.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - https://en.cppreference.com/w/cpp/language/constexpr
+ *  - https://en.cppreference.com/w/cpp/utility/integer_sequence
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_FIXED_MATRIX_H
+#define ECEE_2160_HOMEWORK_FIXED_MATRIX_H
+
+#include <array>            // for std::array
+#include <cstddef>          // for std::size_t
+#include <stdexcept>        // for std::out_of_range
+#include <type_traits>      // for std::enable_if_t
+#include <utility>          // for std::pair, std::index_sequence
+
+/**
+ * A matrix whose dimensions are known at compile time.
+ *
+ * Entries are stored inline in row-major order, so a FixedMatrix never
+ * allocates and index arithmetic reduces to constants. This is the
+ * compile-time sized counterpart of the runtime sized IntMatrix.
+ *
+ * The transpose and product operations are expanded over every entry using
+ * index sequences, so they are fully unrolled, and all operations may be
+ * evaluated at compile time.
+ *
+ * @tparam T Data type of matrix entries.
+ * @tparam R The number of rows.
+ * @tparam C The number of columns.
+ */
+template<typename T, std::size_t R, std::size_t C>
+class FixedMatrix {
+    static_assert(R > 0 && C > 0, "FixedMatrix dimensions must be nonzero.");
+
+    /// The entries of this matrix in row-major order.
+    std::array<T, R * C> m_values;
+
+  public:
+    /// Data type for indexing a matrix via operator[].
+    using Index = std::pair<std::size_t, std::size_t>;
+
+    /// Type for mutable iterators for this matrix.
+    using iterator = T*;
+
+    /// Type for immutable iterators for this matrix.
+    using const_iterator = const T*;
+
+    /**
+     * Constructs a matrix with all entries value-initialized.
+     */
+    constexpr FixedMatrix() : m_values{} {}
+
+    /**
+     * Constructs a matrix from its entries given in row-major order.
+     *
+     * @param values Exactly R * C entries.
+     */
+    template<typename... Ts, typename = std::enable_if_t<sizeof...(Ts) == R * C>>
+    constexpr explicit FixedMatrix(Ts... values) : m_values{{static_cast<T>(values)...}} {}
+
+    /**
+     * Returns the number of rows in the matrix.
+     */
+    static constexpr std::size_t rows() { return R; }
+
+    /**
+     * Returns the number of columns in the matrix.
+     */
+    static constexpr std::size_t cols() { return C; }
+
+    /*
+     * Unchecked entry access.
+     */
+    constexpr T& operator()(std::size_t row, std::size_t col) { return m_values[row * C + col]; }
+
+    constexpr const T& operator()(std::size_t row, std::size_t col) const { return m_values[row * C + col]; }
+
+    /*
+     * Checked entry access matching IntMatrix::operator[].
+     *
+     * Raises std::out_of_range if the index falls outside of the matrix.
+     */
+    constexpr T& operator[](Index elem_index)
+    {
+        if (elem_index.first >= R || elem_index.second >= C) {
+            throw std::out_of_range("invalid matrix index");
+        }
+        return (*this)(elem_index.first, elem_index.second);
+    }
+
+    constexpr const T& operator[](Index elem_index) const
+    {
+        if (elem_index.first >= R || elem_index.second >= C) {
+            throw std::out_of_range("invalid matrix index");
+        }
+        return (*this)(elem_index.first, elem_index.second);
+    }
+
+    /**
+     * Returns the transpose of this matrix.
+     */
+    constexpr FixedMatrix<T, C, R> transpose() const
+    {
+        return transpose_impl(std::make_index_sequence<R * C>{});
+    }
+
+    /**
+     * Computes the transpose of this matrix in-place.
+     *
+     * Only available for square matrices.
+     */
+    template<std::size_t N = R, typename = std::enable_if_t<N == C>>
+    constexpr void transpose_square()
+    {
+        *this = transpose();
+    }
+
+    /**
+     * Returns the matrix product of this matrix and the given matrix.
+     *
+     * @tparam N The number of columns in the right-hand matrix.
+     * @param rhs Right-hand matrix.
+     */
+    template<std::size_t N>
+    constexpr FixedMatrix<T, R, N> operator*(const FixedMatrix<T, C, N>& rhs) const
+    {
+        return multiply_impl(rhs, std::make_index_sequence<R * N>{});
+    }
+
+    constexpr bool operator==(const FixedMatrix& rhs) const
+    {
+        // std::array's operator== is not constexpr until C++20.
+        for (std::size_t i{0}; i < R * C; ++i) {
+            if (!(m_values[i] == rhs.m_values[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const FixedMatrix& rhs) const { return !(*this == rhs); }
+
+    /*
+     * Iterator protocol definitions.
+     */
+    constexpr iterator begin() { return m_values.data(); }
+
+    constexpr iterator end() { return m_values.data() + R * C; }
+
+    constexpr const_iterator begin() const { return m_values.data(); }
+
+    constexpr const_iterator end() const { return m_values.data() + R * C; }
+
+  private:
+    // Grant access to the entries of matrices with other dimensions.
+    template<typename, std::size_t, std::size_t>
+    friend class FixedMatrix;
+
+    /**
+     * Builds the transpose by expanding over every entry of the result.
+     * Entry I of the result is entry (I % R, I / R) of this matrix.
+     */
+    template<std::size_t... I>
+    constexpr FixedMatrix<T, C, R> transpose_impl(std::index_sequence<I...>) const
+    {
+        return FixedMatrix<T, C, R>{(*this)(I % R, I / R)...};
+    }
+
+    /**
+     * Returns the dot product of the given row of this matrix and the given
+     * column of `rhs` by expanding over the shared dimension.
+     */
+    template<std::size_t N, std::size_t... K>
+    constexpr T dot(
+        const FixedMatrix<T, C, N>& rhs,
+        std::size_t row,
+        std::size_t col,
+        std::index_sequence<K...>
+    ) const
+    {
+        T sum{};
+        // Convert each partial sum back to T, since arithmetic on narrow entry
+        // types is carried out in int.
+        ((sum = static_cast<T>(sum + (*this)(row, K) * rhs(K, col))), ...);
+        return sum;
+    }
+
+    /**
+     * Builds the product by expanding over every entry of the result.
+     */
+    template<std::size_t N, std::size_t... I>
+    constexpr FixedMatrix<T, R, N> multiply_impl(
+        const FixedMatrix<T, C, N>& rhs,
+        std::index_sequence<I...>
+    ) const
+    {
+        return FixedMatrix<T, R, N>{dot(rhs, I / N, I % N, std::make_index_sequence<C>{})...};
+    }
+};
+
+#endif //ECEE_2160_HOMEWORK_FIXED_MATRIX_H
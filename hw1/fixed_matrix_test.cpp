@@ -0,0 +1,65 @@
+/*
+ * ECEE 2160 Homework assignment 1 fixed-size matrix tests.
+ *
+ * Checks that construction, entry access, transposes and products of
+ * FixedMatrix can all be evaluated in constant expressions. The checks are
+ * static assertions, so this file fails to compile if any of them fails. At
+ * runtime, it checks that out of range entry access raises
+ * std::out_of_range.
+ *
+ * Usage: hw1-fixed-matrix-test
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "fixed_matrix.h"
+
+#include <cstdint>      // for std::uint8_t
+#include <iostream>     // for std::cout, std::cerr
+#include <stdexcept>    // for std::out_of_range
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+constexpr FixedMatrix<int, 2, 3> A{1, 2, 3, 4, 5, 6};
+constexpr FixedMatrix<int, 3, 2> B{7, 8, 9, 10, 11, 12};
+
+static_assert(FixedMatrix<int, 2, 2>{} == FixedMatrix<int, 2, 2>{0, 0, 0, 0}, "default construction");
+static_assert(A(1, 2) == 6 && A[{0, 1}] == 2, "entry access");
+static_assert(A.transpose() == FixedMatrix<int, 3, 2>{1, 4, 2, 5, 3, 6}, "transpose");
+static_assert(A * B == FixedMatrix<int, 2, 2>{58, 64, 139, 154}, "product");
+static_assert(*(A.end() - 1) == 6 && A.end() - A.begin() == 6, "iterators");
+
+// Products of narrow entries wrap in the entry type: 16 * 16 + 1 = 257.
+static_assert(
+    FixedMatrix<std::uint8_t, 1, 2>{16, 1} * FixedMatrix<std::uint8_t, 2, 1>{16, 1}
+        == FixedMatrix<std::uint8_t, 1, 1>{1},
+    "narrow product"
+);
+
+constexpr FixedMatrix<int, 2, 2> transposed_in_place()
+{
+    FixedMatrix<int, 2, 2> mat{1, 2, 3, 4};
+    mat[{0, 1}] = 5;
+    mat.transpose_square();
+    return mat;
+}
+
+static_assert(transposed_in_place() == FixedMatrix<int, 2, 2>{1, 3, 5, 4}, "in-place transpose");
+
+} // end namespace
+
+int main()
+{
+    FixedMatrix<int, 2, 3> mat{A};
+    try {
+        mat[{2, 0}] = 1;
+    } catch (const std::out_of_range&) {
+        std::cout << "all checks passed\n";
+        return 0;
+    }
+    std::cerr << "FAILED: out of range index accepted\n";
+    return 1;
+}
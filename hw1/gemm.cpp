@@ -0,0 +1,284 @@
+/*
+ * ECEE 2160 Homework assignment 1 matrix multiplication definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - K. Goto and R. A. van de Geijn, "Anatomy of high-performance matrix
+ *    multiplication," ACM Trans. Math. Softw., vol. 34, no. 3, 2008.
+ *  - https://github.com/flame/blis/blob/master/docs/KernelsHowTo.md
+ *  - https://gcc.gnu.org/onlinedocs/gcc/Common-Function-Attributes.html
+ *
+ */
+
+#include "gemm.h"
+
+#include <algorithm>    // for std::min
+#include <cstdint>      // for std::int8_t, ..., std::uint64_t
+#include <stdexcept>    // for std::invalid_argument
+#include <vector>       // for std::vector
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Rows of the product computed by one call of the micro-kernel.
+constexpr std::size_t MR{4};
+
+/// Columns of the product computed by one call of the micro-kernel.
+constexpr std::size_t NR{8};
+
+/// Rows of `a` packed at a time. A packed block of `a` fits in L2.
+constexpr std::size_t MC{64};
+
+/// Columns of `b` packed at a time.
+constexpr std::size_t NC{256};
+
+/// Depth of the packed blocks. A packed MC by KC block of `a` occupies
+/// 64 KiB, and one KC by NR micro-panel of `b` fits in L1.
+constexpr std::size_t KC{256};
+
+/// Type in which products and sums of the given entry type are computed.
+template<typename T>
+using Acc = MatrixWrappingAccumulator<T>;
+
+/**
+ * Signature of a micro-kernel.
+ *
+ * A micro-kernel multiplies an MR by `depth` micro-panel of `a` with a `depth`
+ * by NR micro-panel of `b`, and adds the MR by NR result to the accumulator
+ * tile `acc`, whose rows are `acc_stride` entries apart.
+ */
+template<typename T>
+using MicroKernelFn = void (*)(
+    std::size_t depth,
+    const T* a_panel,
+    const T* b_panel,
+    Acc<T>* acc,
+    std::size_t acc_stride
+);
+
+/**
+ * Portable micro-kernel body.
+ *
+ * The MR by NR tile is accumulated in a local array so that the compiler
+ * can keep it in registers and vectorize the NR-wide inner loop.
+ */
+template<typename T>
+__attribute__((always_inline))
+inline void micro_kernel_body(
+    std::size_t depth,
+    const T* a_panel,
+    const T* b_panel,
+    Acc<T>* acc,
+    std::size_t acc_stride
+)
+{
+    using A = Acc<T>;
+    A tile[MR][NR]{};
+
+    for (std::size_t k{0}; k < depth; ++k) {
+        for (std::size_t i{0}; i < MR; ++i) {
+            const A a_elem{static_cast<A>(a_panel[k * MR + i])};
+            for (std::size_t j{0}; j < NR; ++j) {
+                tile[i][j] += a_elem * static_cast<A>(b_panel[k * NR + j]);
+            }
+        }
+    }
+
+    for (std::size_t i{0}; i < MR; ++i) {
+        for (std::size_t j{0}; j < NR; ++j) {
+            acc[i * acc_stride + j] += tile[i][j];
+        }
+    }
+}
+
+/// Micro-kernel compiled for the baseline instruction set.
+template<typename T>
+void generic_micro_kernel(
+    std::size_t depth,
+    const T* a_panel,
+    const T* b_panel,
+    Acc<T>* acc,
+    std::size_t acc_stride
+)
+{
+    micro_kernel_body(depth, a_panel, b_panel, acc, acc_stride);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/// Micro-kernel compiled for AVX2, which provides 4-wide 32 by 32 to 64-bit
+/// signed multiplication (vpmuldq).
+template<typename T>
+__attribute__((target("avx2")))
+void avx2_micro_kernel(
+    std::size_t depth,
+    const T* a_panel,
+    const T* b_panel,
+    Acc<T>* acc,
+    std::size_t acc_stride
+)
+{
+    micro_kernel_body(depth, a_panel, b_panel, acc, acc_stride);
+}
+#endif
+
+/**
+ * Returns the fastest micro-kernel supported by the processor. The processor
+ * is only queried on the first call.
+ */
+template<typename T>
+MicroKernelFn<T> select_micro_kernel()
+{
+    static const MicroKernelFn<T> kernel = []() -> MicroKernelFn<T> {
+#if defined(__x86_64__) || defined(__i386__)
+        if (__builtin_cpu_supports("avx2")) {
+            return &avx2_micro_kernel<T>;
+        }
+#endif
+        return &generic_micro_kernel<T>;
+    }();
+    return kernel;
+}
+
+/**
+ * Packs a `rows` by `depth` block of a row-major matrix into micro-panels of
+ * MR rows. Each micro-panel stores its entries column by column, so the
+ * micro-kernel reads MR consecutive entries per step. The last micro-panel
+ * is padded with zeros.
+ */
+template<typename T>
+void pack_a(const T* src, std::size_t src_stride, std::size_t rows, std::size_t depth, T* dst)
+{
+    for (std::size_t panel{0}; panel < rows; panel += MR) {
+        const std::size_t panel_rows{std::min(MR, rows - panel)};
+        for (std::size_t k{0}; k < depth; ++k) {
+            for (std::size_t i{0}; i < MR; ++i) {
+                *dst++ = i < panel_rows ? src[(panel + i) * src_stride + k] : T{};
+            }
+        }
+    }
+}
+
+/**
+ * Packs a `depth` by `cols` block of a row-major matrix into micro-panels of
+ * NR columns. Each micro-panel stores its entries row by row, so the
+ * micro-kernel reads NR consecutive entries per step. The last micro-panel
+ * is padded with zeros.
+ */
+template<typename T>
+void pack_b(const T* src, std::size_t src_stride, std::size_t depth, std::size_t cols, T* dst)
+{
+    for (std::size_t panel{0}; panel < cols; panel += NR) {
+        const std::size_t panel_cols{std::min(NR, cols - panel)};
+        for (std::size_t k{0}; k < depth; ++k) {
+            const T* src_row{src + k * src_stride + panel};
+            for (std::size_t j{0}; j < NR; ++j) {
+                *dst++ = j < panel_cols ? src_row[j] : T{};
+            }
+        }
+    }
+}
+
+} // end namespace
+
+template<typename T>
+void multiply(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, GemmMode mode)
+{
+    using A = Acc<T>;
+
+    if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+        throw std::invalid_argument("matrix dimensions do not agree");
+    }
+    if (&c == &a || &c == &b) {
+        throw std::invalid_argument("destination matrix must not be an operand");
+    }
+
+    const std::size_t m{a.rows()};
+    const std::size_t n{b.cols()};
+    const std::size_t k{a.cols()};
+
+    const MicroKernelFn<T> kernel{select_micro_kernel<T>()};
+
+    // Packing buffers and a 64-bit accumulator for one MC by NC block of the
+    // product. Edge micro-panels are padded up to full size.
+    std::vector<T> a_packed(MC * KC);
+    std::vector<T> b_packed(KC * NC);
+    std::vector<A> acc(MC * NC);
+
+    const T* a_values{a.begin()};
+    const T* b_values{b.begin()};
+    T* c_values{c.begin()};
+
+    for (std::size_t jc{0}; jc < n; jc += NC) {
+        const std::size_t nc{std::min(NC, n - jc)};
+
+        for (std::size_t ic{0}; ic < m; ic += MC) {
+            const std::size_t mc{std::min(MC, m - ic)};
+
+            // Seed the accumulator block with zero or with the existing
+            // entries of the destination.
+            for (std::size_t i{0}; i < mc; ++i) {
+                A* acc_row{acc.data() + i * NC};
+                const T* c_row{c_values + (ic + i) * n + jc};
+                for (std::size_t j{0}; j < nc; ++j) {
+                    acc_row[j] = mode == GemmMode::Accumulate ? static_cast<A>(c_row[j]) : A{};
+                }
+            }
+
+            for (std::size_t pc{0}; pc < k; pc += KC) {
+                const std::size_t kc{std::min(KC, k - pc)};
+
+                pack_b(b_values + pc * n + jc, n, kc, nc, b_packed.data());
+                pack_a(a_values + ic * k + pc, k, mc, kc, a_packed.data());
+
+                // Sweep the micro-panels. Full tiles accumulate directly into
+                // the accumulator block; edge tiles go through a scratch tile
+                // so that padded rows and columns are discarded.
+                for (std::size_t jr{0}; jr < nc; jr += NR) {
+                    for (std::size_t ir{0}; ir < mc; ir += MR) {
+                        const T* a_panel{a_packed.data() + ir * kc};
+                        const T* b_panel{b_packed.data() + jr * kc};
+                        A* acc_tile{acc.data() + ir * NC + jr};
+
+                        if (ir + MR <= mc && jr + NR <= nc) {
+                            kernel(kc, a_panel, b_panel, acc_tile, NC);
+                            continue;
+                        }
+
+                        A edge[MR * NR]{};
+                        kernel(kc, a_panel, b_panel, edge, NR);
+                        for (std::size_t i{0}; i < std::min(MR, mc - ir); ++i) {
+                            for (std::size_t j{0}; j < std::min(NR, nc - jr); ++j) {
+                                acc_tile[i * NC + j] += edge[i * NR + j];
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Narrow the finished block into the destination.
+            for (std::size_t i{0}; i < mc; ++i) {
+                const A* acc_row{acc.data() + i * NC};
+                T* c_row{c_values + (ic + i) * n + jc};
+                for (std::size_t j{0}; j < nc; ++j) {
+                    c_row[j] = static_cast<T>(acc_row[j]);
+                }
+            }
+        }
+    }
+}
+
+// Explicit instantiations for the supported entry types.
+template void multiply(const Matrix<std::int8_t>&, const Matrix<std::int8_t>&, Matrix<std::int8_t>&, GemmMode);
+template void multiply(const Matrix<std::int16_t>&, const Matrix<std::int16_t>&, Matrix<std::int16_t>&, GemmMode);
+template void multiply(const Matrix<std::int32_t>&, const Matrix<std::int32_t>&, Matrix<std::int32_t>&, GemmMode);
+template void multiply(const Matrix<std::int64_t>&, const Matrix<std::int64_t>&, Matrix<std::int64_t>&, GemmMode);
+template void multiply(const Matrix<std::uint8_t>&, const Matrix<std::uint8_t>&, Matrix<std::uint8_t>&, GemmMode);
+template void multiply(const Matrix<std::uint16_t>&, const Matrix<std::uint16_t>&, Matrix<std::uint16_t>&, GemmMode);
+template void multiply(const Matrix<std::uint32_t>&, const Matrix<std::uint32_t>&, Matrix<std::uint32_t>&, GemmMode);
+template void multiply(const Matrix<std::uint64_t>&, const Matrix<std::uint64_t>&, Matrix<std::uint64_t>&, GemmMode);
+template void multiply(const Matrix<float>&, const Matrix<float>&, Matrix<float>&, GemmMode);
+template void multiply(const Matrix<double>&, const Matrix<double>&, Matrix<double>&, GemmMode);
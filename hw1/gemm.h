@@ -0,0 +1,70 @@
+/*
+ * ECEE 2160 Homework assignment 1 matrix multiplication declarations.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_GEMM_H
+#define ECEE_2160_HOMEWORK_GEMM_H
+
+#include "matrix.h"
+
+/**
+ * Specifies how the product of a matrix multiplication is combined with the
+ * existing entries of the destination matrix.
+ */
+enum class GemmMode {
+    /// The product replaces the destination: C = A * B.
+    Overwrite,
+    /// The product is added to the destination: C += A * B.
+    Accumulate,
+};
+
+/**
+ * Computes the matrix product of `a` and `b`, storing the result in `c`.
+ *
+ * The product is computed by a blocked algorithm. Blocks of `a` and `b` are
+ * packed into contiguous panels sized to remain in cache, and a register
+ * blocked micro-kernel computes small tiles of the product from the panels.
+ * Products and sums are accumulated using 64-bit integers. Each entry of the
+ * result is narrowed to the entry type once, after all of its terms have been
+ * summed. Whether the 64-bit sums are exact depends on the inner dimension K:
+ *
+ *  - For 8- and 16-bit signed entries, each product has magnitude at most
+ *    2^30, so sums never overflow for K up to 2^32.
+ *  - For 32-bit signed entries, each product has magnitude up to 2^62, so
+ *    only the sum of a single product is guaranteed to fit. Sums of K
+ *    products cannot overflow if every entry has magnitude below
+ *    2^31 / sqrt(K). Larger entries may overflow the accumulator.
+ *  - Unsigned entries are accumulated modulo 2^64, so the narrowed result
+ *    is the exact product modulo 2^w for w-bit entries, for every K.
+ *    Products of 64-bit entries likewise wrap modulo 2^64.
+ *
+ * Floating point entries are accumulated in double precision.
+ *
+ * On x86 processors supporting AVX2, a micro-kernel compiled for AVX2 is
+ * selected at runtime.
+ *
+ * This function raises std::invalid_argument if the dimensions of the
+ * matrices do not agree, or if `c` is the same matrix as `a` or `b`.
+ *
+ * This function is explicitly instantiated in gemm.cpp for signed and
+ * unsigned integers of 8, 16, 32 and 64 bits, `float` and `double`.
+ *
+ * @tparam T Data type of matrix entries.
+ * @param a Left-hand matrix with dimensions M by K.
+ * @param b Right-hand matrix with dimensions K by N.
+ * @param c Destination matrix with dimensions M by N.
+ * @param mode Whether the product replaces or is added to `c`.
+ */
+template<typename T>
+void multiply(
+    const Matrix<T>& a,
+    const Matrix<T>& b,
+    Matrix<T>& c,
+    GemmMode mode = GemmMode::Overwrite
+);
+
+#endif //ECEE_2160_HOMEWORK_GEMM_H
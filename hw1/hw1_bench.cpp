@@ -0,0 +1,783 @@
+/*
+ * ECEE 2160 Homework assignment 1 transpose and multiply benchmarks.
+ *
+ * Times each transpose and multiply path of Matrix over a sweep of sizes,
+ * including the in-place transpose of rectangular matrices,
+ * as well as modular powers, determinants, and the transpose and
+ * matrix-vector product of CSR sparse matrices, and writes the results to
+ * standard output as JSON. The parallel transpose and the sparse
+ * matrix-vector product are timed with 1, 2, 4 and so on threads up to the
+ * number of hardware threads, and every result records its thread count.
+ * The sizes of the transpose and multiply sweep are each power of two from
+ * 8, the next size up, and the size halfway to the next power of two, since
+ * power of two strides map many rows onto the same cache sets and are not
+ * representative of other sizes. Alongside the timings, hardware counters for
+ * cache misses, data TLB misses and retired instructions are read with
+ * perf_event_open where the kernel permits it.
+ *
+ * Usage: hw1-bench [--max-size N] [--max-multiply-size N]
+ *                  [--max-algebra-size N] [--max-sparse-size N]
+ *                  [--max-cycle-size N] [--warmup N] [--repeats N]
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+ *
+ */
+
+#include "gemm.h"
+#include "matrix.h"
+#include "matrix_algebra.h"
+#include "matrix_batch.h"
+#include "sparse_matrix.h"
+
+#include <algorithm>    // for std::sort, std::max, std::fill
+#include <chrono>       // for std::chrono::steady_clock
+#include <cstdint>      // for std::uint64_t
+#include <cstdlib>      // for std::strtoull
+#include <cstring>      // for std::strcmp
+#include <functional>   // for std::function
+#include <iostream>     // for std::cout, std::cerr
+#include <thread>       // for std::thread
+#include <vector>       // for std::vector
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Smallest matrix size in the sweep.
+constexpr std::size_t MIN_SIZE{8};
+
+/// Default largest matrix size of the transpose sweep.
+constexpr std::size_t DEFAULT_MAX_SIZE{32768};
+
+/// Default largest row count of the rectangular in-place transpose.
+/// cycle_transpose() follows cycles through the whole matrix, so nearly
+/// every access of a large matrix misses the cache.
+constexpr std::size_t DEFAULT_MAX_CYCLE_SIZE{8192};
+
+/// Default largest matrix size of the multiply sweep. Multiplication takes
+/// cubic time, so the sweep stops well before the transpose sweep.
+constexpr std::size_t DEFAULT_MAX_MULTIPLY_SIZE{2048};
+
+/// Short dimension of the rectangular multiply benchmarks.
+/// "multiply_tall_skinny" multiplies a size by RECT_DIM matrix with a
+/// RECT_DIM by size matrix, and "multiply_short_wide" multiplies a RECT_DIM
+/// by size matrix with a size by RECT_DIM matrix.
+constexpr std::size_t RECT_DIM{32};
+
+/// Smallest matrix size of the power and determinant sweep.
+constexpr std::size_t MIN_ALGEBRA_SIZE{64};
+
+/// Default largest matrix size of the power and determinant sweep.
+constexpr std::size_t DEFAULT_MAX_ALGEBRA_SIZE{4096};
+
+/// Default largest matrix size of the sparse matrix sweep. The sparse
+/// matrices are built from dense matrices, which bounds the size.
+constexpr std::size_t DEFAULT_MAX_SPARSE_SIZE{8192};
+
+/// Nonzero entries in each row of the sparse matrices.
+constexpr std::size_t SPARSE_ROW_NONZEROS{16};
+
+/// Exponent of the power benchmark, which takes four squarings.
+constexpr std::uint64_t POWER_EXPONENT{16};
+
+/// Modulus of the power benchmark, the prime 10^9 + 7.
+constexpr std::uint32_t POWER_MODULUS{1000000007};
+
+/// Number of arithmetic operations each timed run of the power and
+/// determinant sweep should perform at least.
+constexpr double MIN_RUN_OPS{1e9};
+
+/// Default number of untimed runs before the timed runs.
+constexpr std::size_t DEFAULT_WARMUP{1};
+
+/// Default number of timed runs.
+constexpr std::size_t DEFAULT_REPEATS{5};
+
+/// Number of bytes each timed run should move at least. Small matrices are
+/// processed repeatedly within a run so that runs are long enough to time.
+constexpr std::size_t MIN_RUN_BYTES{std::size_t{64} << 20u};
+
+/// Number of matrices in the batched benchmarks.
+constexpr std::size_t BATCH_COUNT{1u << 20u};
+
+/**
+ * A hardware event counter for the calling thread, opened with
+ * perf_event_open.
+ *
+ * The counter is inherited by threads created after it is opened, so the
+ * events of the worker threads of the parallel paths are included once the
+ * workers have exited. The kernel only adds the events of exited threads to
+ * the counter and never resets them, so a count is taken as the difference
+ * of two reads rather than by resetting the counter.
+ *
+ * Only user space events are counted, which unprivileged processes may do
+ * under the default perf_event_paranoid setting. If the counter cannot be
+ * opened, for example inside a virtual machine without a virtual PMU, the
+ * counter is invalid and reads nothing.
+ */
+class PerfCounter {
+    /// File descriptor of the counter, or -1 if unavailable.
+    int m_fd{-1};
+
+    /// Value read by start().
+    std::uint64_t m_start{0};
+
+    /**
+     * Returns the current value of the counter, or zero if it cannot be read.
+     */
+    std::uint64_t read_count() const
+    {
+        std::uint64_t count{0};
+        if (read(m_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) {
+            count = 0;
+        }
+        return count;
+    }
+
+  public:
+    PerfCounter(std::uint32_t type, std::uint64_t config)
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~PerfCounter()
+    {
+        if (m_fd != -1) {
+            close(m_fd);
+        }
+    }
+
+    PerfCounter(const PerfCounter&) = delete;
+
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    /**
+     * Returns `true` if the counter was opened.
+     */
+    explicit operator bool() const { return m_fd != -1; }
+
+    /**
+     * Starts counting.
+     */
+    void start()
+    {
+        if (m_fd != -1) {
+            m_start = read_count();
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    /**
+     * Stops counting and returns the number of events since start().
+     */
+    std::uint64_t stop()
+    {
+        std::uint64_t count{0};
+        if (m_fd != -1) {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            const std::uint64_t end{read_count()};
+            count = end >= m_start ? end - m_start : 0;
+        }
+        return count;
+    }
+};
+
+/**
+ * The hardware counters recorded for each benchmark.
+ */
+struct Counters {
+    PerfCounter cache_misses{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+    PerfCounter dtlb_misses{
+        PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_DTLB
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8u)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16u)
+    };
+    PerfCounter instructions{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+};
+
+/**
+ * Summary of the timed runs of one benchmark.
+ */
+struct Measurement {
+    /// Fastest run, in seconds.
+    double min_seconds;
+    /// Median run, in seconds.
+    double median_seconds;
+    /// Events per run, summed over the timed runs and divided by their
+    /// number.
+    double cache_misses;
+    double dtlb_misses;
+    double instructions;
+};
+
+/**
+ * Benchmark settings taken from the command line.
+ */
+struct Options {
+    std::size_t max_size{DEFAULT_MAX_SIZE};
+    std::size_t max_multiply_size{DEFAULT_MAX_MULTIPLY_SIZE};
+    std::size_t max_algebra_size{DEFAULT_MAX_ALGEBRA_SIZE};
+    std::size_t max_sparse_size{DEFAULT_MAX_SPARSE_SIZE};
+    std::size_t max_cycle_size{DEFAULT_MAX_CYCLE_SIZE};
+    std::size_t warmup{DEFAULT_WARMUP};
+    std::size_t repeats{DEFAULT_REPEATS};
+};
+
+/**
+ * Runs the given function `warmup` times untimed, then `repeats` times while
+ * timing each run and counting hardware events over all timed runs.
+ */
+Measurement measure(
+    const std::function<void()>& run,
+    const Options& options,
+    Counters& counters
+)
+{
+    for (std::size_t i{0}; i < options.warmup; ++i) {
+        run();
+    }
+
+    std::vector<double> seconds;
+    seconds.reserve(options.repeats);
+
+    counters.cache_misses.start();
+    counters.dtlb_misses.start();
+    counters.instructions.start();
+    for (std::size_t i{0}; i < options.repeats; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto stop = std::chrono::steady_clock::now();
+        seconds.push_back(std::chrono::duration<double>(stop - start).count());
+    }
+    const auto cache_misses = counters.cache_misses.stop();
+    const auto dtlb_misses = counters.dtlb_misses.stop();
+    const auto instructions = counters.instructions.stop();
+
+    std::sort(seconds.begin(), seconds.end());
+    const auto runs = static_cast<double>(options.repeats);
+    return Measurement{
+        seconds.front(),
+        seconds[seconds.size() / 2],
+        static_cast<double>(cache_misses) / runs,
+        static_cast<double>(dtlb_misses) / runs,
+        static_cast<double>(instructions) / runs,
+    };
+}
+
+/**
+ * Writes the given counter value as JSON, or null if the counter is not
+ * available.
+ */
+void write_counter(std::ostream& out, const PerfCounter& counter, double value)
+{
+    if (counter) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+/**
+ * Writes one benchmark result as a JSON object.
+ *
+ * @param name Name of the benchmarked function.
+ * @param size Matrix size, or the number of matrices for batched benchmarks.
+ * @param iterations Number of times the function ran within each timed run.
+ * @param bytes Bytes read and written by one call of the function.
+ * @param ops Arithmetic operations performed by one call, or 0 for
+ *            transposes.
+ * @param threads Number of threads the function ran on.
+ */
+void write_result(
+    std::ostream& out,
+    bool& first,
+    const char* name,
+    std::size_t size,
+    std::size_t iterations,
+    double bytes,
+    double ops,
+    const Measurement& m,
+    const Counters& counters,
+    std::size_t threads = 1
+)
+{
+    const auto calls = static_cast<double>(iterations);
+    out << (first ? "\n" : ",\n") << "    {"
+        << "\"benchmark\": \"" << name << "\", "
+        << "\"size\": " << size << ", "
+        << "\"iterations\": " << iterations << ", "
+        << "\"threads\": " << threads << ", "
+        << "\"seconds_min\": " << m.min_seconds / calls << ", "
+        << "\"seconds_median\": " << m.median_seconds / calls << ", "
+        << "\"gb_per_s\": " << bytes * calls / m.min_seconds / 1e9;
+    if (ops != 0) {
+        out << ", \"gops\": " << ops * calls / m.min_seconds / 1e9;
+    }
+    out << ", \"cache_misses\": ";
+    write_counter(out, counters.cache_misses, m.cache_misses / calls);
+    out << ", \"dtlb_misses\": ";
+    write_counter(out, counters.dtlb_misses, m.dtlb_misses / calls);
+    out << ", \"instructions\": ";
+    write_counter(out, counters.instructions, m.instructions / calls);
+    out << '}';
+    first = false;
+}
+
+/**
+ * Returns a square matrix of the given size with distinct entries, touching
+ * every page so that page faults are not timed.
+ */
+IntMatrix make_matrix(std::size_t size, PagePolicy policy = PagePolicy::Normal)
+{
+    IntMatrix mat(size, size, policy);
+    int value{0};
+    for (auto& elem : mat) {
+        elem = value++;
+    }
+    return mat;
+}
+
+/**
+ * Returns a matrix of the given dimensions with distinct entries.
+ */
+IntMatrix make_matrix(std::size_t rows, std::size_t cols)
+{
+    IntMatrix mat(rows, cols);
+    int value{0};
+    for (auto& elem : mat) {
+        elem = value++;
+    }
+    return mat;
+}
+
+/**
+ * Returns a square matrix of the given size whose determinant is 1 or -1,
+ * but which still needs row swaps and a full elimination: a unit upper
+ * triangular matrix with entries in {-1, 0, 1}, with its rows reversed.
+ */
+IntMatrix make_unimodular_matrix(std::size_t size)
+{
+    IntMatrix mat(size, size);
+    unsigned state{1};
+    for (std::size_t i{0}; i < size; ++i) {
+        int* const row{&mat(size - 1 - i, 0)};
+        for (std::size_t j{0}; j < size; ++j) {
+            // A linear congruential generator is random enough here.
+            state = state * 1103515245u + 12345u;
+            row[j] = j < i ? 0 : j == i ? 1 : static_cast<int>((state >> 16u) % 3) - 1;
+        }
+    }
+    return mat;
+}
+
+/**
+ * Returns a square sparse matrix of the given size with
+ * SPARSE_ROW_NONZEROS nonzero entries in each row, in scattered columns.
+ */
+CsrMatrix<int> make_sparse_matrix(std::size_t size)
+{
+    IntMatrix dense(size, size);
+    std::fill(dense.begin(), dense.end(), 0);
+    unsigned state{1};
+    for (std::size_t row{0}; row < size; ++row) {
+        for (std::size_t i{0}; i < SPARSE_ROW_NONZEROS; ++i) {
+            // A linear congruential generator is random enough here.
+            state = state * 1103515245u + 12345u;
+            dense(row, (state >> 8u) % size) = static_cast<int>(i + 1);
+        }
+    }
+    return CsrMatrix<int>(dense);
+}
+
+/**
+ * Returns the sizes of the transpose and multiply sweep that do not exceed
+ * the given size: each power of two from MIN_SIZE, one more than it, and
+ * one and a half times it.
+ */
+std::vector<std::size_t> sweep_sizes(std::size_t max_size)
+{
+    std::vector<std::size_t> sizes;
+    for (std::size_t size{MIN_SIZE}; size <= max_size; size *= 2) {
+        for (const std::size_t candidate : {size, size + 1, size + size / 2}) {
+            if (candidate <= max_size) {
+                sizes.push_back(candidate);
+            }
+        }
+    }
+    return sizes;
+}
+
+/**
+ * Returns the thread counts of the scaling benchmarks: 1, 2, 4 and so on up
+ * to the number of hardware threads, which is always included.
+ */
+std::vector<std::size_t> scaling_thread_counts()
+{
+    // hardware_concurrency() may return 0 if the count is unknown.
+    const std::size_t hardware_threads{std::max(std::thread::hardware_concurrency(), 1u)};
+    std::vector<std::size_t> counts;
+    for (std::size_t threads{1}; threads < hardware_threads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(hardware_threads);
+    return counts;
+}
+
+/**
+ * Parses the command line into the given options.
+ *
+ * @return `false` if the command line is malformed.
+ */
+bool parse_options(int argc, char* argv[], Options& options)
+{
+    for (int i{1}; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const auto value = static_cast<std::size_t>(std::strtoull(argv[i + 1], nullptr, 10));
+        if (std::strcmp(argv[i], "--max-size") == 0) {
+            options.max_size = value;
+        } else if (std::strcmp(argv[i], "--max-multiply-size") == 0) {
+            options.max_multiply_size = value;
+        } else if (std::strcmp(argv[i], "--max-algebra-size") == 0) {
+            options.max_algebra_size = value;
+        } else if (std::strcmp(argv[i], "--max-sparse-size") == 0) {
+            options.max_sparse_size = value;
+        } else if (std::strcmp(argv[i], "--max-cycle-size") == 0) {
+            options.max_cycle_size = value;
+        } else if (std::strcmp(argv[i], "--warmup") == 0) {
+            options.warmup = value;
+        } else if (std::strcmp(argv[i], "--repeats") == 0) {
+            options.repeats = value;
+        } else {
+            return false;
+        }
+    }
+    return options.repeats != 0;
+}
+
+/**
+ * Returns the name of the given kernel set for the report.
+ */
+const char* kernel_set_name(transpose_kernels::KernelSet kernels)
+{
+    switch (kernels) {
+        case transpose_kernels::KernelSet::Scalar:
+            return "scalar";
+        case transpose_kernels::KernelSet::Sse2:
+            return "sse2";
+        case transpose_kernels::KernelSet::Avx2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+} // end namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--max-size N] [--max-multiply-size N]"
+                  << " [--max-algebra-size N] [--max-sparse-size N] [--max-cycle-size N]"
+                  << " [--warmup N] [--repeats N]\n";
+        return 1;
+    }
+
+    Counters counters;
+    const std::vector<std::size_t> thread_counts{scaling_thread_counts()};
+    auto& out = std::cout;
+    bool first{true};
+
+    out << "{\n"
+        << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+        << "  \"kernel_set\": \"" << kernel_set_name(transpose_kernels::best_kernel_set()) << "\",\n"
+        << "  \"warmup\": " << options.warmup << ",\n"
+        << "  \"repeats\": " << options.repeats << ",\n"
+        << "  \"results\": [";
+
+    for (const std::size_t size : sweep_sizes(options.max_size)) {
+        // Every transpose reads and writes each entry once.
+        const auto bytes = static_cast<double>(2 * size * size * sizeof(int));
+        const std::size_t iterations{std::max(
+            MIN_RUN_BYTES / static_cast<std::size_t>(bytes), std::size_t{1}
+        )};
+
+        // Runs the given in-place transpose `iterations` times per run.
+        const auto bench_in_place = [&](
+            const char* name,
+            IntMatrix& mat,
+            const std::function<void(IntMatrix&)>& transpose,
+            std::size_t threads = 1
+        ) {
+            const Measurement m{measure(
+                [&] {
+                    for (std::size_t i{0}; i < iterations; ++i) {
+                        transpose(mat);
+                    }
+                },
+                options,
+                counters
+            )};
+            write_result(out, first, name, size, iterations, bytes, 0, m, counters, threads);
+        };
+
+        {
+            IntMatrix mat{make_matrix(size)};
+            bench_in_place("index_transpose_square", mat, [](IntMatrix& m) {
+                m.index_transpose_square();
+            });
+            bench_in_place("pointer_transpose_square", mat, [](IntMatrix& m) {
+                m.pointer_transpose_square();
+            });
+            bench_in_place("blocked_transpose_square", mat, [](IntMatrix& m) {
+                m.blocked_transpose_square();
+            });
+            for (const std::size_t threads : thread_counts) {
+                bench_in_place("parallel_transpose_square", mat, [threads](IntMatrix& m) {
+                    m.parallel_transpose_square(threads);
+                }, threads);
+            }
+            bench_in_place("recursive_transpose_square", mat, [](IntMatrix& m) {
+                m.recursive_transpose_square();
+            });
+            bench_in_place("expression_transpose", mat, [](IntMatrix& m) {
+                m = m.t();
+            });
+        }
+
+        if (size * size * sizeof(int) >= matrix_storage::HUGE_PAGE_SIZE) {
+            IntMatrix mat{make_matrix(size, PagePolicy::HugePages)};
+            bench_in_place("blocked_transpose_square_huge_pages", mat, [](IntMatrix& m) {
+                m.blocked_transpose_square();
+            });
+        }
+
+        {
+            const IntMatrix src{make_matrix(size)};
+            IntMatrix dst{make_matrix(size)};
+            const Measurement m{measure(
+                [&] {
+                    for (std::size_t i{0}; i < iterations; ++i) {
+                        src.transpose_into(dst);
+                    }
+                },
+                options,
+                counters
+            )};
+            write_result(out, first, "transpose_into", size, iterations, bytes, 0, m, counters);
+        }
+
+        if (size <= options.max_cycle_size) {
+            // A matrix with half as many columns as rows. Each call swaps the
+            // dimensions, so every other call transposes the matrix back.
+            IntMatrix mat{make_matrix(size, size / 2)};
+            const auto cycle_bytes = static_cast<double>(2 * size * (size / 2) * sizeof(int));
+            const std::size_t cycle_iterations{std::max(
+                MIN_RUN_BYTES / static_cast<std::size_t>(cycle_bytes), std::size_t{1}
+            )};
+            const Measurement m{measure(
+                [&] {
+                    for (std::size_t i{0}; i < cycle_iterations; ++i) {
+                        mat.cycle_transpose();
+                    }
+                },
+                options,
+                counters
+            )};
+            write_result(out, first, "cycle_transpose", size, cycle_iterations, cycle_bytes, 0, m, counters);
+        }
+
+        if (size <= options.max_multiply_size) {
+            const IntMatrix a{make_matrix(size)};
+            const IntMatrix b{make_matrix(size)};
+            IntMatrix c{make_matrix(size)};
+            const auto n = static_cast<double>(size);
+            const auto multiply_bytes = static_cast<double>(3 * size * size * sizeof(int));
+            const std::size_t multiply_iterations{std::max(
+                MIN_RUN_BYTES / static_cast<std::size_t>(multiply_bytes), std::size_t{1}
+            )};
+            const Measurement m{measure(
+                [&] {
+                    for (std::size_t i{0}; i < multiply_iterations; ++i) {
+                        multiply(a, b, c);
+                    }
+                },
+                options,
+                counters
+            )};
+            write_result(
+                out, first, "multiply", size, multiply_iterations,
+                multiply_bytes, 2 * n * n * n, m, counters
+            );
+
+            // Rectangular products with one short dimension, which leave the
+            // blocked kernel with thin panels.
+            const auto bench_rect = [&](const char* name, std::size_t rows, std::size_t depth, std::size_t cols) {
+                const IntMatrix rect_a{make_matrix(rows, depth)};
+                const IntMatrix rect_b{make_matrix(depth, cols)};
+                IntMatrix rect_c{make_matrix(rows, cols)};
+                const auto rect_bytes = static_cast<double>(
+                    (rows * depth + depth * cols + rows * cols) * sizeof(int)
+                );
+                const double rect_ops{
+                    2 * static_cast<double>(rows) * static_cast<double>(depth) * static_cast<double>(cols)
+                };
+                const std::size_t rect_iterations{std::max(
+                    MIN_RUN_BYTES / static_cast<std::size_t>(rect_bytes), std::size_t{1}
+                )};
+                const Measurement rect_m{measure(
+                    [&] {
+                        for (std::size_t i{0}; i < rect_iterations; ++i) {
+                            multiply(rect_a, rect_b, rect_c);
+                        }
+                    },
+                    options,
+                    counters
+                )};
+                write_result(
+                    out, first, name, size, rect_iterations, rect_bytes, rect_ops, rect_m, counters
+                );
+            };
+            bench_rect("multiply_tall_skinny", size, RECT_DIM, size);
+            bench_rect("multiply_short_wide", RECT_DIM, size, RECT_DIM);
+        }
+    }
+
+    for (std::size_t size{MIN_ALGEBRA_SIZE}; size <= options.max_algebra_size; size *= 2) {
+        const auto n = static_cast<double>(size);
+        const auto matrix_bytes = static_cast<double>(size * size * sizeof(int));
+
+        {
+            const IntMatrix mat{make_matrix(size)};
+            // Each squaring is one product of 2 n^3 operations.
+            const double ops{4 * 2 * n * n * n};
+            const auto iterations = static_cast<std::size_t>(std::max(MIN_RUN_OPS / ops, 1.0));
+            const Measurement m{measure(
+                [&] {
+                    for (std::size_t i{0}; i < iterations; ++i) {
+                        (void) power_mod(mat, POWER_EXPONENT, POWER_MODULUS);
+                    }
+                },
+                options,
+                counters
+            )};
+            write_result(
+                out, first, "power_mod", size, iterations, 4 * 3 * matrix_bytes, ops, m, counters
+            );
+        }
+
+        {
+            const IntMatrix mat{make_unimodular_matrix(size)};
+            // Elimination updates about n^3 / 3 entries with 2 operations each.
+            const double ops{2 * n * n * n / 3};
+            const auto iterations = static_cast<std::size_t>(std::max(MIN_RUN_OPS / ops, 1.0));
+            const Measurement m{measure(
+                [&] {
+                    for (std::size_t i{0}; i < iterations; ++i) {
+                        (void) determinant(mat);
+                    }
+                },
+                options,
+                counters
+            )};
+            write_result(
+                out, first, "determinant", size, iterations, 2 * 2 * matrix_bytes, ops, m, counters
+            );
+        }
+    }
+
+    for (std::size_t size{MIN_SIZE}; size <= options.max_sparse_size; size *= 2) {
+        const CsrMatrix<int> mat{make_sparse_matrix(size)};
+        const auto nonzeros = static_cast<double>(mat.nonzeros());
+        // Each nonzero entry is stored as a value and a column index.
+        const double entry_bytes{nonzeros * static_cast<double>(sizeof(int) + sizeof(std::size_t))};
+        const auto offset_bytes = static_cast<double>((size + 1) * sizeof(std::size_t));
+
+        {
+            // The transpose reads and writes every entry and row offset.
+            const double bytes{2 * (entry_bytes + offset_bytes)};
+            const std::size_t iterations{std::max(
+                MIN_RUN_BYTES / static_cast<std::size_t>(bytes), std::size_t{1}
+            )};
+            const Measurement m{measure(
+                [&] {
+                    for (std::size_t i{0}; i < iterations; ++i) {
+                        (void) mat.transpose();
+                    }
+                },
+                options,
+                counters
+            )};
+            write_result(out, first, "csr_transpose", size, iterations, bytes, 0, m, counters);
+        }
+
+        {
+            const std::vector<int> x(size, 1);
+            std::vector<int> y(size);
+            // The product reads every entry and row offset and both vectors.
+            const double bytes{entry_bytes + offset_bytes + static_cast<double>(2 * size * sizeof(int))};
+            const std::size_t iterations{std::max(
+                MIN_RUN_BYTES / static_cast<std::size_t>(bytes), std::size_t{1}
+            )};
+            for (const std::size_t threads : thread_counts) {
+                const Measurement m{measure(
+                    [&] {
+                        for (std::size_t i{0}; i < iterations; ++i) {
+                            mat.multiply(x.data(), y.data(), threads);
+                        }
+                    },
+                    options,
+                    counters
+                )};
+                write_result(
+                    out, first, "csr_multiply", size, iterations, bytes, 2 * nonzeros, m, counters, threads
+                );
+            }
+        }
+    }
+
+    // Batched 3 by 3 matrices, reported per batch.
+    {
+        MatrixBatch<int, 3, 3> a(BATCH_COUNT);
+        MatrixBatch<int, 3, 3> b(BATCH_COUNT);
+        MatrixBatch<int, 3, 3> c(BATCH_COUNT);
+        a.fill(1);
+        b.fill(2);
+        c.fill(0);
+        const auto count = static_cast<double>(BATCH_COUNT);
+
+        const Measurement transpose_m{measure([&] { a.transpose_square(); }, options, counters)};
+        write_result(
+            out, first, "batch_transpose_square_3x3", BATCH_COUNT, 1,
+            2 * 9 * sizeof(int) * count, 0, transpose_m, counters
+        );
+
+        const Measurement multiply_m{measure([&] { multiply(a, b, c); }, options, counters)};
+        write_result(
+            out, first, "batch_multiply_3x3", BATCH_COUNT, 1,
+            3 * 9 * sizeof(int) * count, 2 * 27 * count, multiply_m, counters
+        );
+    }
+
+    out << "\n  ]\n}\n";
+}
@@ -1,5 +1,8 @@
 /*
- * ECEE 2160 Homework assignment 1 matrix definitions.
+ * ECEE 2160 Homework assignment 1 matrix storage definitions.
+ *
+ * The member functions of Matrix are templated and defined in matrix.tpp.
+ * This file only defines the untemplated storage allocation routines.
  *
  * Author:  Brian Schubert
  * Date:    2020-07-13
@@ -8,106 +11,50 @@
  * References
  * ==========
  *
- *  - https://en.cppreference.com/w/cpp/header/stdexcept
+ *  - https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_memalign.html
+ *  - https://www.kernel.org/doc/html/latest/admin-guide/mm/transhuge.html
  *
  */
 
 #include "matrix.h"
 
-#include <iostream>     // for i/o definitions
-#include <stdexcept>    // for std::logic_error
-#include <utility>      // for std::swap
+#include <cstdlib>      // for posix_memalign, std::free
+#include <new>          // for std::bad_alloc
 
-/**
- * Delimiter for print matrices.
- *
- * Defined using C-style string instead of a string view since the compiler
- * on the COE machines do not support C++17.
- */
-constexpr const char DELIM[] = "\t\t";
+#include <sys/mman.h>   // for madvise
 
-IntMatrix::IntMatrix(std::size_t rows, std::size_t cols)
-    : m_rows{rows},
-      m_cols{cols},
-      // We allow the allocation of zero sized arrays and assume that
-      // (rows * cols) < std::numeric_limits<std::size_t>::max()
-      m_values{new IntMatrix::Elem[rows * cols]} {}
-
-IntMatrix::~IntMatrix()
-{
-    delete[] m_values;
-    m_values = nullptr;
-}
+namespace matrix_storage {
 
-IntMatrix::Elem& IntMatrix::operator[](IntMatrix::Index elem_index)
+void* allocate(std::size_t bytes, PagePolicy policy)
 {
-    const auto row = elem_index.first;
-    const auto col = elem_index.second;
-
-    if (row >= m_rows || col >= m_cols) {
-        throw std::out_of_range("invalid matrix index");
+    if (bytes == 0) {
+        return nullptr;
     }
-    return m_values[row * m_cols + col];
-}
 
-void IntMatrix::index_transpose_square()
-{
-    // Transpose is only defined for square matrices in this assignment.
-    if (m_cols != m_rows) {
-        throw std::logic_error("matrix must be square");
-    }
+    // Align huge page requests to the huge page size so that the kernel can
+    // back the whole allocation with huge pages.
+    const bool huge_pages{policy == PagePolicy::HugePages && bytes >= HUGE_PAGE_SIZE};
+    const std::size_t alignment{huge_pages ? HUGE_PAGE_SIZE : ALIGNMENT};
 
-    // Iterator over the indices of the lower-triangular portion of the matrix
-    //
-    // For a 3x3 matrix, we only need to perform 3 swaps.
-    for (std::size_t i_row{1}; i_row < m_rows; ++i_row) {
-        for (std::size_t i_col{0}; i_col < i_row; ++i_col) {
-            std::swap(
-                // Call IntMatrix::operator[] to perform array indexing.
-                (*this)[{i_row, i_col}],
-                (*this)[{i_col, i_row}]
-            );
-        }
+    void* storage{nullptr};
+    if (posix_memalign(&storage, alignment, bytes) != 0) {
+        throw std::bad_alloc();
     }
-}
 
-void IntMatrix::pointer_transpose_square()
-{
-    // Transpose is only defined for square matrices in this assignment.
-    if (m_cols != m_rows) {
-        throw std::logic_error("matrix must be square");
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) {
+        // The advice is only a hint. Failure, for example when transparent
+        // huge pages are disabled, leaves the storage usable with normal pages.
+        (void) madvise(storage, bytes, MADV_HUGEPAGE);
     }
+#endif
 
-    // Iterator over the pointer offsets corresponding to the lower-triangular
-    // portion of the matrix
-    for (std::size_t i_row{1}; i_row < m_rows; ++i_row) {
-        for (std::size_t i_col{0}; i_col < i_row; ++i_col) {
-            std::swap(
-                *(m_values + (i_row * m_cols + i_col)),
-                *(m_values + (i_col * m_cols + i_row))
-            );
-        }
-    }
+    return storage;
 }
 
-std::ostream& operator<<(std::ostream& out, const IntMatrix& mat)
+void deallocate(void* storage) noexcept
 {
-    std::size_t col_counter{0};
-    for (const auto elem : mat) {
-        // Cycle column counter
-        col_counter = (col_counter + 1) % mat.m_cols;
-        // If this is the last column of a row, print a newline.
-        out << elem << (col_counter == 0 ? "\n" : DELIM);
-    }
-    return out;
+    std::free(storage);
 }
 
-std::istream& operator>>(std::istream& in, IntMatrix& mat)
-{
-    for (auto& elem : mat) {
-        in >> elem;
-    }
-    return in;
-}
-
-
+} // end namespace matrix_storage
@@ -10,20 +10,160 @@
 #ifndef ECEE_2160_HOMEWORK_MATRIX_H
 #define ECEE_2160_HOMEWORK_MATRIX_H
 
+#include "matrix_expr.h"
+#include "transpose_kernels.h"
+
 #include <cstdint>      // for std::size_t
 #include <iosfwd>       // for std::ostream (no definitions)
+#include <type_traits>  // for std::is_arithmetic, std::conditional_t, std::enable_if_t
 #include <utility>      // for std::pair
 
 /**
- * A matrix with integer entries.
+ * Requests for how the memory backing a matrix is mapped.
+ */
+enum class PagePolicy {
+    /// Use the default page size.
+    Normal,
+    /**
+     * Request transparent huge pages for allocations of at least one huge
+     * page. This reduces TLB misses when large matrices are walked column by
+     * column. Ignored on systems without transparent huge pages.
+     */
+    HugePages,
+};
+
+/**
+ * Accumulator type for sums and products of matrix entries of type T.
+ *
+ * Signed integers accumulate in int64_t, which holds any product of entries
+ * of up to 32 bits exactly, and unsigned integers accumulate in uint64_t.
+ * Floating point entries accumulate in double.
+ */
+template<typename T>
+using MatrixAccumulator = std::conditional_t<
+    std::is_floating_point<T>::value,
+    double,
+    std::conditional_t<std::is_signed<T>::value, std::int64_t, std::uint64_t>
+>;
+
+/**
+ * Type in which sums of type MatrixAccumulator<T> are computed.
+ *
+ * Sums of 64-bit signed entries may overflow int64_t, which is undefined, so
+ * they are computed in uint64_t, where overflow wraps, and converted to
+ * int64_t once complete. The result is the true sum modulo 2^64, like the
+ * sums of every other integer type. Sums of other entries are computed in
+ * MatrixAccumulator<T> itself.
+ */
+template<typename T>
+using MatrixWrappingAccumulator = std::conditional_t<
+    std::is_integral<T>::value && sizeof(T) == sizeof(std::uint64_t),
+    std::uint64_t,
+    MatrixAccumulator<T>
+>;
+
+/**
+ * A non-owning view of a contiguous run of matrix entries, such as one row
+ * of a Matrix.
+ *
+ * This is a minimal stand-in for C++20's std::span. Element access is
+ * unchecked, so loops over a RowSpan compile to the same code as loops over
+ * a raw pointer and may be vectorized.
+ *
+ * @tparam T Data type of the entries, const-qualified for read-only views.
+ */
+template<typename T>
+class RowSpan {
+    /// The first entry of the run.
+    T* m_data;
+
+    /// The number of entries in the run.
+    std::size_t m_size;
+
+  public:
+    /// Data type of the entries without qualifiers.
+    using value_type = std::remove_const_t<T>;
+
+    /// Type for iterators over the entries.
+    using iterator = T*;
+
+    constexpr RowSpan(T* data, std::size_t size) noexcept : m_data{data}, m_size{size} {}
+
+    /// Allow implicit conversion from a mutable span to a read-only span.
+    template<typename U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+    constexpr RowSpan(RowSpan<U> other) noexcept : m_data{other.data()}, m_size{other.size()} {}
+
+    /**
+     * Returns a pointer to the first entry.
+     */
+    constexpr T* data() const noexcept { return m_data; }
+
+    /**
+     * Returns the number of entries.
+     */
+    constexpr std::size_t size() const noexcept { return m_size; }
+
+    /**
+     * Returns the entry at the given position. The position is not checked.
+     */
+    constexpr T& operator[](std::size_t index) const noexcept { return m_data[index]; }
+
+    /*
+     * Iterator protocol definitions.
+     */
+    constexpr iterator begin() const noexcept { return m_data; }
+
+    constexpr iterator end() const noexcept { return m_data + m_size; }
+};
+
+namespace matrix_storage {
+
+/// Alignment of matrix entries, in bytes. Matches the cache line size, so
+/// SIMD kernels may use aligned loads on the first entry of each matrix.
+constexpr std::size_t ALIGNMENT{64};
+
+/// Size of a transparent huge page on x86-64 and ARM Linux, in bytes.
+constexpr std::size_t HUGE_PAGE_SIZE{std::size_t{2} << 20u};
+
+/**
+ * Allocates uninitialized storage of the given size aligned to ALIGNMENT
+ * bytes.
+ *
+ * Raises std::bad_alloc if the allocation fails.
+ *
+ * @param bytes Size of the allocation.
+ * @param policy Page mapping request.
+ * @return Pointer to the storage, or nullptr if `bytes` is zero.
+ */
+void* allocate(std::size_t bytes, PagePolicy policy);
+
+/**
+ * Releases storage obtained from allocate(). Does nothing for nullptr.
+ */
+void deallocate(void* storage) noexcept;
+
+} // end namespace matrix_storage
+
+/**
+ * A matrix with arithmetic entries.
  *
  * We implement manual dynamic memory allocations to store matrix entries per
- * the assignment instructions.
+ * the assignment instructions. Entries are stored in row-major order in a
+ * single allocation aligned to matrix_storage::ALIGNMENT bytes.
+ *
+ * Matrices may be moved, but not copied, so that every deep copy is explicit.
+ *
+ * @tparam T Data type of matrix entries.
  */
-class IntMatrix {
+template<typename T>
+class Matrix {
+    static_assert(std::is_arithmetic<T>::value, "Matrix entries must be arithmetic.");
+
+  public:
     /// Data type for matrix entries.
-    using Elem = int;
+    using Elem = T;
 
+  private:
     /// The number of rows in this matrix
     std::size_t m_rows;
 
@@ -48,9 +188,61 @@ class IntMatrix {
     /// Type for immutable iterators for this matrix.
     using const_iterator = const Elem*;
 
-    IntMatrix(std::size_t rows, std::size_t cols);
+    /**
+     * Default tile width used by blocked_transpose_square().
+     *
+     * Two 64 by 64 tiles of 4-byte entries occupy 32 KiB, which fits in the
+     * L1 data cache of most desktop processors.
+     */
+    static constexpr std::size_t DEFAULT_TILE_SIZE{64};
+
+    /**
+     * Constructs a matrix with the given dimensions and uninitialized entries.
+     *
+     * @param rows The number of rows.
+     * @param cols The number of columns.
+     * @param policy Page mapping request for the entries.
+     */
+    Matrix(std::size_t rows, std::size_t cols, PagePolicy policy = PagePolicy::Normal);
+
+    /**
+     * Constructs a matrix holding the entries of the given lazy expression.
+     *
+     * The expression is evaluated in a single pass directly into the new
+     * matrix. Each entry is converted to the entry type of this matrix.
+     *
+     * @param expr Matrix expression, such as `a + b.t() * 3`.
+     * @param policy Page mapping request for the entries.
+     */
+    template<typename E>
+    Matrix(const MatrixExpr<E>& expr, PagePolicy policy = PagePolicy::Normal);
+
+    ~Matrix();
 
-    ~IntMatrix();
+    /**
+     * Replaces the entries of this matrix with those of the given lazy
+     * expression, adopting the dimensions of the expression.
+     *
+     * Expressions made only of element-wise operations are evaluated with a
+     * single flat loop over the entries that the compiler can vectorize.
+     * Expressions involving a transpose are evaluated tile by tile so that
+     * the transposed operand is read a cache line at a time. If a transposed
+     * expression reads from this matrix, it is evaluated into a new matrix
+     * first, since entries would otherwise be overwritten before being read.
+     */
+    template<typename E>
+    Matrix& operator=(const MatrixExpr<E>& expr);
+
+    /**
+     * Returns a lazy expression for the transpose of this matrix.
+     *
+     * No entries are moved. The expression may be combined with other
+     * expressions, and is evaluated when assigned to a matrix.
+     */
+    TransposeExpr<MatrixLeaf<T>> t() const
+    {
+        return TransposeExpr<MatrixLeaf<T>>{MatrixLeaf<T>{*this}};
+    }
 
     /**
      * Computes the transpose of this matrix in-place using array-index syntax.
@@ -67,6 +259,126 @@ class IntMatrix {
     */
     void pointer_transpose_square();
 
+    /**
+     * Computes the transpose of this matrix in-place by swapping square tiles.
+     *
+     * The matrix is partitioned into tiles of `tile_size` by `tile_size`
+     * entries. Each tile in the lower-triangular portion of the matrix is
+     * swapped with its mirror tile from the upper-triangular portion while
+     * being transposed, and each tile on the diagonal is transposed in-place.
+     * Both tiles of a pair stay resident in cache while they are swapped,
+     * avoiding the cache miss per element incurred by the column-wise walk of
+     * index_transpose_square() once the matrix outgrows the cache.
+     *
+     * For 32-bit entry types, full blocks within each tile are transposed by
+     * the fastest SIMD kernels supported by the processor, as reported by
+     * transpose_kernels::best_kernel_set(). Blocks along the edges of the
+     * matrix, and entries of other sizes, are transposed by scalar code.
+     *
+     * This function raises std::logic_error is the matrix is not square, and
+     * std::invalid_argument if the tile size is zero.
+     *
+     * @param tile_size Width of the square tiles, in entries.
+     */
+    void blocked_transpose_square(std::size_t tile_size = DEFAULT_TILE_SIZE);
+
+    /**
+     * Computes the transpose of this matrix in-place by swapping square tiles,
+     * using the given family of SIMD kernels for full blocks.
+     *
+     * This function raises std::logic_error is the matrix is not square, and
+     * std::invalid_argument if the tile size is zero or if the kernels are
+     * not supported by the processor.
+     *
+     * @param tile_size Width of the square tiles, in entries.
+     * @param kernels Kernel family used for full blocks.
+     */
+    void blocked_transpose_square(std::size_t tile_size, transpose_kernels::KernelSet kernels);
+
+    /**
+     * Computes the transpose of this matrix in-place by swapping square tiles,
+     * dividing the tile pairs between the given number of threads.
+     *
+     * The tile pairs of the lower-triangular portion of the matrix are
+     * numbered row by row and split into equally sized contiguous runs, one
+     * per thread. Since every tile pair moves the same number of entries, the
+     * work stays balanced even though the rows of the triangle hold different
+     * numbers of tiles. The calling thread processes one of the runs.
+     *
+     * This function raises std::logic_error is the matrix is not square, and
+     * std::invalid_argument if the tile size is zero.
+     *
+     * @param thread_count Number of threads, or 0 to use one thread per
+     *                     hardware thread.
+     * @param tile_size Width of the square tiles, in entries.
+     */
+    void parallel_transpose_square(
+        std::size_t thread_count,
+        std::size_t tile_size = DEFAULT_TILE_SIZE
+    );
+
+    /**
+     * Computes the transpose of this matrix in-place by swapping square tiles
+     * across the given number of threads, using the given family of SIMD
+     * kernels for full blocks.
+     *
+     * This function raises std::logic_error is the matrix is not square, and
+     * std::invalid_argument if the tile size is zero or if the kernels are
+     * not supported by the processor.
+     *
+     * @param thread_count Number of threads, or 0 to use one thread per
+     *                     hardware thread.
+     * @param tile_size Width of the square tiles, in entries.
+     * @param kernels Kernel family used for full blocks.
+     */
+    void parallel_transpose_square(
+        std::size_t thread_count,
+        std::size_t tile_size,
+        transpose_kernels::KernelSet kernels
+    );
+
+    /**
+     * Computes the transpose of this matrix in-place, exchanging its row and
+     * column counts. Unlike the other transpose functions, the matrix need
+     * not be square.
+     *
+     * Entries are permuted by following the cycles of the transpose
+     * permutation, so no second matrix is allocated. A bitset with one bit
+     * per entry tracks which entries have already been moved. Square
+     * matrices are transposed with blocked_transpose_square() instead.
+     */
+    void cycle_transpose();
+
+    /**
+     * Computes the transpose of this matrix in-place by recursively dividing
+     * it into quadrants.
+     *
+     * The diagonal quadrants are transposed recursively, and the two
+     * off-diagonal quadrants are swapped while being transposed by splitting
+     * the longer side of the pair in half until both blocks are small. At
+     * some depth of the recursion, the pair of blocks fits in each level of
+     * the cache, so no tile size needs to be tuned for the processor.
+     *
+     * This function raises std::logic_error is the matrix is not square.
+     */
+    void recursive_transpose_square();
+
+    /**
+     * Writes the transpose of this matrix to the given matrix, which is
+     * resized to have as many rows as this matrix has columns if needed.
+     * Unlike the other transpose functions, the matrix need not be square.
+     *
+     * Blocks are divided recursively as in recursive_transpose_square(). Large
+     * destinations are written with non-temporal stores where the processor
+     * supports them, so that the destination does not evict the source from
+     * the cache while it is written.
+     *
+     * This function raises std::invalid_argument if `dst` is this matrix.
+     *
+     * @param dst Matrix receiving the transpose.
+     */
+    void transpose_into(Matrix& dst) const;
+
     /**
      * Returns the number of rows in the matrix.
      */
@@ -78,18 +390,20 @@ class IntMatrix {
     std::size_t cols() const { return m_cols; }
 
     /*
-     * Move semantics were out of the scope of this lab.
-     *
-     * To prevent accidents, we explicitly disallow the compiler from generating
-     * definitions for {copy,move} {constructors, assignment operators}.
+     * Copying is disallowed so that deep copies of large matrices cannot
+     * happen by accident.
      */
-    IntMatrix(const IntMatrix&) = delete;
+    Matrix(const Matrix&) = delete;
 
-    IntMatrix(IntMatrix&&) = delete;
+    Matrix& operator=(const Matrix&) = delete;
 
-    IntMatrix& operator=(const IntMatrix&) = delete;
+    /*
+     * Moves transfer ownership of the entries. The moved-from matrix is left
+     * empty with zero rows and columns.
+     */
+    Matrix(Matrix&& other) noexcept;
 
-    IntMatrix& operator=(IntMatrix&&) = delete;
+    Matrix& operator=(Matrix&& other) noexcept;
 
     /*
      * Custom indexing operator to simplify translation of 2D indexes to the
@@ -97,18 +411,43 @@ class IntMatrix {
      */
     Elem& operator[](Index elem_index);
 
+    const Elem& operator[](Index elem_index) const;
+
+    /*
+     * Checked entry access. Raises std::out_of_range if the row or column is
+     * out of range, like operator[], but without building an Index.
+     */
+    Elem& at(std::size_t row, std::size_t col);
+
+    const Elem& at(std::size_t row, std::size_t col) const;
+
     /*
-     * I/O stream operators.
+     * Unchecked entry access for hot loops. Indexing outside of the matrix
+     * is undefined behavior. Since nothing can throw, loops over entries
+     * accessed this way may be vectorized.
+     */
+    Elem& operator()(std::size_t row, std::size_t col) { return m_values[row * m_cols + col]; }
+
+    const Elem& operator()(std::size_t row, std::size_t col) const
+    {
+        return m_values[row * m_cols + col];
+    }
+
+    /**
+     * Returns a view of the contiguous entries of the given row.
+     *
+     * The row index is checked once here, raising std::out_of_range if it is
+     * out of range. Entries accessed through the view are not checked.
      */
-    friend std::ostream& operator<<(std::ostream& out, const IntMatrix& mat);
+    RowSpan<Elem> row(std::size_t row_index);
 
-    friend std::istream& operator>>(std::istream& in, IntMatrix& mat);
+    RowSpan<const Elem> row(std::size_t row_index) const;
 
     /*
     * Iterator protocol definitions.
      *
-     * Mutable iterators are used by operator>>(std::istream&, IntMatrix&).
-     * Immutable iterators are used by operator<<(std::ostream&, const IntMatrix&).
+     * Mutable iterators are used by operator>>(std::istream&, Matrix&).
+     * Immutable iterators are used by operator<<(std::ostream&, const Matrix&).
     */
     iterator begin() { return m_values; }
 
@@ -119,4 +458,18 @@ class IntMatrix {
     const_iterator end() const { return m_values + (m_rows * m_cols); }
 };
 
+/// A matrix with integer entries.
+using IntMatrix = Matrix<int>;
+
+/*
+ * I/O stream operators.
+ */
+template<typename T>
+std::ostream& operator<<(std::ostream& out, const Matrix<T>& mat);
+
+template<typename T>
+std::istream& operator>>(std::istream& in, Matrix<T>& mat);
+
+#include "matrix.tpp"
+
 #endif //ECEE_2160_HOMEWORK_MATRIX_H
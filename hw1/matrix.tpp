@@ -0,0 +1,734 @@
+/*
+ * ECEE 2160 Homework assignment 1 matrix definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ * Due:     2020-07-17
+ *
+ * References
+ * ==========
+ *
+ *  - https://en.cppreference.com/w/cpp/header/stdexcept
+ *  - https://en.wikipedia.org/wiki/Loop_nest_optimization
+ *  - https://en.wikipedia.org/wiki/In-place_matrix_transposition
+ *  - https://en.wikipedia.org/wiki/Cache-oblivious_algorithm
+ *
+ */
+
+#include <algorithm>    // for std::min, std::max
+#include <cmath>        // for std::sqrt
+#include <cstring>      // for std::memcpy
+#include <istream>      // for std::istream
+#include <limits>       // for std::numeric_limits
+#include <new>          // for std::bad_array_new_length
+#include <ostream>      // for std::ostream
+#include <stdexcept>    // for std::logic_error, std::invalid_argument
+#include <thread>       // for std::thread
+#include <utility>      // for std::swap, std::exchange
+#include <vector>       // for std::vector
+
+#if defined(__SSE2__)
+#include <emmintrin.h>  // for _mm_stream_si32, _mm_stream_si64, _mm_sfence
+#endif
+
+namespace matrix_detail {
+
+/**
+ * Delimiter for print matrices.
+ *
+ * Defined using C-style string instead of a string view since the compiler
+ * on the COE machines do not support C++17.
+ */
+constexpr const char DELIM[] = "\t\t";
+
+/**
+ * Width of the blocks transposed entry by entry when no SIMD kernel applies
+ * to the entry type.
+ */
+constexpr std::size_t SCALAR_BLOCK{8};
+
+/**
+ * Swap-transposes the entries on or below the diagonal of the tile spanning
+ * rows [tile_row, row_end) and columns [tile_col, col_end) of a square matrix
+ * with their mirror entries above the diagonal.
+ *
+ * For 32-bit entries, full blocks within the tile are transposed by the given
+ * SIMD kernels. Other blocks are transposed entry by entry.
+ */
+template<typename T>
+void swap_transpose_tile(
+    T* values,
+    std::size_t size,
+    std::size_t tile_row,
+    std::size_t tile_col,
+    std::size_t row_end,
+    std::size_t col_end,
+    transpose_kernels::KernelSet kernels
+)
+{
+    // The SIMD kernels move 32-bit entries. Other entry sizes are always
+    // transposed entry by entry.
+    constexpr bool use_kernel{sizeof(T) == 4};
+    const auto kernel = transpose_kernels::swap_transpose_kernel(kernels);
+    const std::size_t block{use_kernel ? transpose_kernels::block_width(kernels) : SCALAR_BLOCK};
+
+    // Split the tile into kernel-sized blocks, only visiting the blocks on or
+    // below the diagonal.
+    for (std::size_t block_row{tile_row}; block_row < row_end; block_row += block) {
+        const std::size_t block_col_end{std::min(col_end, block_row + 1)};
+
+        for (std::size_t block_col{tile_col}; block_col < block_col_end; block_col += block) {
+            // Full blocks are handed to the kernel. A block on the
+            // diagonal is its own mirror and is transposed in-place.
+            if (use_kernel && block_row + block <= row_end && block_col + block <= col_end) {
+                kernel(
+                    values + (block_row * size + block_col),
+                    values + (block_col * size + block_row),
+                    size
+                );
+                continue;
+            }
+
+            // Partial blocks along the edges of the matrix or tile
+            // are transposed entry by entry.
+            const std::size_t i_row_end{std::min(block_row + block, row_end)};
+            for (std::size_t i_row{block_row}; i_row < i_row_end; ++i_row) {
+                const std::size_t i_col_end{std::min({block_col + block, col_end, i_row})};
+                for (std::size_t i_col{block_col}; i_col < i_col_end; ++i_col) {
+                    std::swap(
+                        values[i_row * size + i_col],
+                        values[i_col * size + i_row]
+                    );
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Swap-transposes the tile pairs with linear indices in [first, last) of a
+ * square matrix.
+ *
+ * Tile pairs are numbered row by row through the lower-triangular portion of
+ * the tile grid, including the diagonal: (0, 0), (1, 0), (1, 1), (2, 0), ...
+ * Distinct tile pairs touch disjoint entries, so disjoint index ranges may be
+ * processed concurrently.
+ *
+ * @tparam T Data type of matrix entries.
+ * @param values Matrix entries.
+ * @param size Number of rows and columns of the matrix.
+ * @param tile_size Width of the square tiles.
+ * @param kernels Kernel family used for full blocks within each tile.
+ * @param first Linear index of the first tile pair.
+ * @param last Linear index one past the last tile pair.
+ */
+template<typename T>
+void transpose_tile_pairs(
+    T* values,
+    std::size_t size,
+    std::size_t tile_size,
+    transpose_kernels::KernelSet kernels,
+    std::size_t first,
+    std::size_t last
+)
+{
+    if (first >= last) {
+        return;
+    }
+
+    // Locate the tile grid position of the first tile pair. Tile row t begins
+    // at linear index t * (t + 1) / 2, so t is the largest row with a starting
+    // index not exceeding `first`. The floating point estimate is corrected to
+    // guard against rounding.
+    auto grid_row = static_cast<std::size_t>(
+        (std::sqrt(8.0 * static_cast<double>(first) + 1.0) - 1.0) / 2.0
+    );
+    while (grid_row * (grid_row + 1) / 2 > first) {
+        --grid_row;
+    }
+    while ((grid_row + 1) * (grid_row + 2) / 2 <= first) {
+        ++grid_row;
+    }
+    std::size_t grid_col{first - grid_row * (grid_row + 1) / 2};
+
+    for (std::size_t pair{first}; pair < last; ++pair) {
+        const std::size_t tile_row{grid_row * tile_size};
+        const std::size_t tile_col{grid_col * tile_size};
+        const std::size_t row_end{std::min(tile_row + tile_size, size)};
+        const std::size_t col_end{std::min(tile_col + tile_size, size)};
+
+        swap_transpose_tile(values, size, tile_row, tile_col, row_end, col_end, kernels);
+
+        // Advance to the next tile pair in the lower-triangular tile grid.
+        if (++grid_col > grid_row) {
+            ++grid_row;
+            grid_col = 0;
+        }
+    }
+}
+
+/// Width of the square tiles used to evaluate non-linear expressions.
+constexpr std::size_t EXPR_TILE{64};
+
+/**
+ * Writes the entries of the given expression to the given row-major storage.
+ */
+template<typename T, typename E>
+void evaluate(const E& expr, T* dst)
+{
+    const std::size_t rows{expr.rows()};
+    const std::size_t cols{expr.cols()};
+
+    if constexpr (E::is_linear) {
+        // Every operand shares the same row-major layout, so the whole
+        // expression is evaluated with one flat loop.
+        const std::size_t size{rows * cols};
+        for (std::size_t i{0}; i < size; ++i) {
+            dst[i] = static_cast<T>(expr.at(i));
+        }
+    } else {
+        // Evaluate tile by tile so that transposed operands, which are read
+        // column by column, reuse each cache line across a whole tile.
+        for (std::size_t tile_row{0}; tile_row < rows; tile_row += EXPR_TILE) {
+            const std::size_t row_end{std::min(tile_row + EXPR_TILE, rows)};
+            for (std::size_t tile_col{0}; tile_col < cols; tile_col += EXPR_TILE) {
+                const std::size_t col_end{std::min(tile_col + EXPR_TILE, cols)};
+                for (std::size_t i_row{tile_row}; i_row < row_end; ++i_row) {
+                    for (std::size_t i_col{tile_col}; i_col < col_end; ++i_col) {
+                        dst[i_row * cols + i_col] = static_cast<T>(expr(i_row, i_col));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Returns the number of tile pairs in the lower-triangular portion of the
+ * tile grid of a square matrix, including the diagonal.
+ */
+inline std::size_t tile_pair_count(std::size_t size, std::size_t tile_size)
+{
+    const std::size_t grid_size{(size + tile_size - 1) / tile_size};
+    return grid_size * (grid_size + 1) / 2;
+}
+
+/// Side length at which the recursive transposes stop dividing blocks. A
+/// block of 16 by 16 entries stays in L1 for any entry type, holds whole
+/// cache lines of 4-byte entries, and divides evenly into SIMD kernel blocks.
+constexpr std::size_t RECURSION_BASE{16};
+
+/// Size in bytes above which transpose_into() bypasses the cache with
+/// non-temporal stores. Smaller destinations are likely to be read again
+/// soon while still in the cache.
+constexpr std::size_t STREAMING_THRESHOLD{std::size_t{8} << 20u};
+
+/**
+ * Returns where to split a block side longer than RECURSION_BASE. Splits fall
+ * on multiples of RECURSION_BASE, so that base blocks line up with the SIMD
+ * kernel blocks and with the cache lines of the matrix rows.
+ */
+inline std::size_t recursion_split(std::size_t length)
+{
+    const std::size_t half{length / 2};
+    return std::max(half - half % RECURSION_BASE, RECURSION_BASE);
+}
+
+/**
+ * Swaps the block of the given dimensions at (row, col) of a square matrix
+ * with its mirror block at (col, row), transposing both. The block must lie
+ * below the diagonal.
+ */
+template<typename T>
+void recursive_swap_transpose(
+    T* values,
+    std::size_t size,
+    std::size_t row,
+    std::size_t col,
+    std::size_t rows,
+    std::size_t cols,
+    transpose_kernels::KernelSet kernels
+)
+{
+    if (rows <= RECURSION_BASE && cols <= RECURSION_BASE) {
+        swap_transpose_tile(values, size, row, col, row + rows, col + cols, kernels);
+    } else if (rows >= cols) {
+        const std::size_t split{recursion_split(rows)};
+        recursive_swap_transpose(values, size, row, col, split, cols, kernels);
+        recursive_swap_transpose(values, size, row + split, col, rows - split, cols, kernels);
+    } else {
+        const std::size_t split{recursion_split(cols)};
+        recursive_swap_transpose(values, size, row, col, rows, split, kernels);
+        recursive_swap_transpose(values, size, row, col + split, rows, cols - split, kernels);
+    }
+}
+
+/**
+ * Transposes the square block of the given width on the diagonal of a square
+ * matrix in-place.
+ */
+template<typename T>
+void recursive_transpose_diagonal(
+    T* values,
+    std::size_t size,
+    std::size_t start,
+    std::size_t width,
+    transpose_kernels::KernelSet kernels
+)
+{
+    if (width <= RECURSION_BASE) {
+        swap_transpose_tile(values, size, start, start, start + width, start + width, kernels);
+        return;
+    }
+
+    const std::size_t split{recursion_split(width)};
+    recursive_transpose_diagonal(values, size, start, split, kernels);
+    recursive_transpose_diagonal(values, size, start + split, width - split, kernels);
+    // Lower-left quadrant, swapped with the upper-right quadrant.
+    recursive_swap_transpose(values, size, start + split, start, width - split, split, kernels);
+}
+
+/**
+ * Stores the given entry with a non-temporal store if the processor supports
+ * one for entries of this size, and with an ordinary store otherwise.
+ *
+ * Non-temporal stores must be followed by stream_fence() before the stored
+ * entries are read by another thread.
+ */
+template<typename T>
+inline void stream_store(T* dst, T value)
+{
+#if defined(__SSE2__)
+    if constexpr (sizeof(T) == sizeof(int)) {
+        int bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        _mm_stream_si32(reinterpret_cast<int*>(dst), bits);
+        return;
+    }
+#if defined(__x86_64__)
+    if constexpr (sizeof(T) == sizeof(long long)) {
+        long long bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        _mm_stream_si64(reinterpret_cast<long long*>(dst), bits);
+        return;
+    }
+#endif
+#endif
+    *dst = value;
+}
+
+/**
+ * Orders earlier non-temporal stores before any later stores.
+ */
+inline void stream_fence()
+{
+#if defined(__SSE2__)
+    _mm_sfence();
+#endif
+}
+
+/**
+ * Writes the transpose of the block of the given dimensions at (row, col) of
+ * the source matrix to the destination matrix.
+ *
+ * @tparam Streaming Whether to use non-temporal stores.
+ */
+template<bool Streaming, typename T>
+void recursive_copy_transpose(
+    const T* src,
+    std::size_t src_cols,
+    T* dst,
+    std::size_t dst_cols,
+    std::size_t row,
+    std::size_t col,
+    std::size_t rows,
+    std::size_t cols
+)
+{
+    if (rows <= RECURSION_BASE && cols <= RECURSION_BASE) {
+        // Write each destination row segment contiguously, so that
+        // non-temporal stores fill whole cache lines at a time.
+        for (std::size_t i_col{col}; i_col < col + cols; ++i_col) {
+            for (std::size_t i_row{row}; i_row < row + rows; ++i_row) {
+                if constexpr (Streaming) {
+                    stream_store(&dst[i_col * dst_cols + i_row], src[i_row * src_cols + i_col]);
+                } else {
+                    dst[i_col * dst_cols + i_row] = src[i_row * src_cols + i_col];
+                }
+            }
+        }
+    } else if (rows >= cols) {
+        const std::size_t split{recursion_split(rows)};
+        recursive_copy_transpose<Streaming>(src, src_cols, dst, dst_cols, row, col, split, cols);
+        recursive_copy_transpose<Streaming>(
+            src, src_cols, dst, dst_cols, row + split, col, rows - split, cols
+        );
+    } else {
+        const std::size_t split{recursion_split(cols)};
+        recursive_copy_transpose<Streaming>(src, src_cols, dst, dst_cols, row, col, rows, split);
+        recursive_copy_transpose<Streaming>(
+            src, src_cols, dst, dst_cols, row, col + split, rows, cols - split
+        );
+    }
+}
+
+} // end namespace matrix_detail
+
+template<typename T>
+Matrix<T>::Matrix(std::size_t rows, std::size_t cols, PagePolicy policy)
+    : m_rows{rows},
+      m_cols{cols},
+      m_values{nullptr}
+{
+    // We allow the allocation of zero sized matrices, but reject sizes whose
+    // byte count cannot be represented.
+    if (cols != 0 && rows > std::numeric_limits<std::size_t>::max() / sizeof(Elem) / cols) {
+        throw std::bad_array_new_length();
+    }
+    // Entries are arithmetic, so the raw storage needs no construction.
+    m_values = static_cast<Elem*>(matrix_storage::allocate(rows * cols * sizeof(Elem), policy));
+}
+
+template<typename T>
+template<typename E>
+Matrix<T>::Matrix(const MatrixExpr<E>& expr, PagePolicy policy)
+    : Matrix(expr.rows(), expr.cols(), policy)
+{
+    matrix_detail::evaluate(expr.self(), m_values);
+}
+
+template<typename T>
+template<typename E>
+Matrix<T>& Matrix<T>::operator=(const MatrixExpr<E>& expr)
+{
+    const bool in_place_safe{E::is_linear || !expr.self().aliases(begin(), end())};
+
+    if (in_place_safe && m_rows == expr.rows() && m_cols == expr.cols()) {
+        matrix_detail::evaluate(expr.self(), m_values);
+    } else {
+        // Evaluate into new storage before releasing the current entries,
+        // which the expression may still read.
+        *this = Matrix(expr);
+    }
+    return *this;
+}
+
+template<typename T>
+Matrix<T>::~Matrix()
+{
+    matrix_storage::deallocate(m_values);
+    m_values = nullptr;
+}
+
+template<typename T>
+Matrix<T>::Matrix(Matrix&& other) noexcept
+    : m_rows{std::exchange(other.m_rows, 0)},
+      m_cols{std::exchange(other.m_cols, 0)},
+      m_values{std::exchange(other.m_values, nullptr)} {}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator=(Matrix&& other) noexcept
+{
+    if (this != &other) {
+        // Release our entries before taking ownership of the other matrix's.
+        matrix_storage::deallocate(m_values);
+        m_rows = std::exchange(other.m_rows, 0);
+        m_cols = std::exchange(other.m_cols, 0);
+        m_values = std::exchange(other.m_values, nullptr);
+    }
+    return *this;
+}
+
+template<typename T>
+typename Matrix<T>::Elem& Matrix<T>::operator[](Index elem_index)
+{
+    const auto row = elem_index.first;
+    const auto col = elem_index.second;
+
+    if (row >= m_rows || col >= m_cols) {
+        throw std::out_of_range("invalid matrix index");
+    }
+    return m_values[row * m_cols + col];
+}
+
+template<typename T>
+const typename Matrix<T>::Elem& Matrix<T>::operator[](Index elem_index) const
+{
+    const auto row = elem_index.first;
+    const auto col = elem_index.second;
+
+    if (row >= m_rows || col >= m_cols) {
+        throw std::out_of_range("invalid matrix index");
+    }
+    return m_values[row * m_cols + col];
+}
+
+template<typename T>
+typename Matrix<T>::Elem& Matrix<T>::at(std::size_t row, std::size_t col)
+{
+    if (row >= m_rows || col >= m_cols) {
+        throw std::out_of_range("invalid matrix index");
+    }
+    return m_values[row * m_cols + col];
+}
+
+template<typename T>
+const typename Matrix<T>::Elem& Matrix<T>::at(std::size_t row, std::size_t col) const
+{
+    if (row >= m_rows || col >= m_cols) {
+        throw std::out_of_range("invalid matrix index");
+    }
+    return m_values[row * m_cols + col];
+}
+
+template<typename T>
+RowSpan<typename Matrix<T>::Elem> Matrix<T>::row(std::size_t row_index)
+{
+    if (row_index >= m_rows) {
+        throw std::out_of_range("invalid matrix index");
+    }
+    return RowSpan<Elem>{m_values + row_index * m_cols, m_cols};
+}
+
+template<typename T>
+RowSpan<const typename Matrix<T>::Elem> Matrix<T>::row(std::size_t row_index) const
+{
+    if (row_index >= m_rows) {
+        throw std::out_of_range("invalid matrix index");
+    }
+    return RowSpan<const Elem>{m_values + row_index * m_cols, m_cols};
+}
+
+template<typename T>
+void Matrix<T>::index_transpose_square()
+{
+    // Transpose is only defined for square matrices in this assignment.
+    if (m_cols != m_rows) {
+        throw std::logic_error("matrix must be square");
+    }
+
+    // Iterator over the indices of the lower-triangular portion of the matrix
+    //
+    // For a 3x3 matrix, we only need to perform 3 swaps.
+    for (std::size_t i_row{1}; i_row < m_rows; ++i_row) {
+        for (std::size_t i_col{0}; i_col < i_row; ++i_col) {
+            std::swap(
+                // Call Matrix::operator[] to perform array indexing.
+                (*this)[{i_row, i_col}],
+                (*this)[{i_col, i_row}]
+            );
+        }
+    }
+}
+
+template<typename T>
+void Matrix<T>::pointer_transpose_square()
+{
+    // Transpose is only defined for square matrices in this assignment.
+    if (m_cols != m_rows) {
+        throw std::logic_error("matrix must be square");
+    }
+
+    // Iterator over the pointer offsets corresponding to the lower-triangular
+    // portion of the matrix
+    for (std::size_t i_row{1}; i_row < m_rows; ++i_row) {
+        for (std::size_t i_col{0}; i_col < i_row; ++i_col) {
+            std::swap(
+                *(m_values + (i_row * m_cols + i_col)),
+                *(m_values + (i_col * m_cols + i_row))
+            );
+        }
+    }
+}
+
+template<typename T>
+void Matrix<T>::blocked_transpose_square(std::size_t tile_size)
+{
+    blocked_transpose_square(tile_size, transpose_kernels::best_kernel_set());
+}
+
+template<typename T>
+void Matrix<T>::blocked_transpose_square(
+    std::size_t tile_size,
+    transpose_kernels::KernelSet kernels
+)
+{
+    parallel_transpose_square(1, tile_size, kernels);
+}
+
+template<typename T>
+void Matrix<T>::parallel_transpose_square(std::size_t thread_count, std::size_t tile_size)
+{
+    parallel_transpose_square(thread_count, tile_size, transpose_kernels::best_kernel_set());
+}
+
+template<typename T>
+void Matrix<T>::parallel_transpose_square(
+    std::size_t thread_count,
+    std::size_t tile_size,
+    transpose_kernels::KernelSet kernels
+)
+{
+    // Transpose is only defined for square matrices in this assignment.
+    if (m_cols != m_rows) {
+        throw std::logic_error("matrix must be square");
+    }
+    if (tile_size == 0) {
+        throw std::invalid_argument("tile size must be nonzero");
+    }
+    if (!transpose_kernels::is_supported(kernels)) {
+        throw std::invalid_argument("transpose kernels not supported by this processor");
+    }
+
+    if (thread_count == 0) {
+        // hardware_concurrency() may return 0 if the count is unknown.
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const std::size_t pair_count{matrix_detail::tile_pair_count(m_rows, tile_size)};
+    thread_count = std::min(thread_count, std::max(pair_count, std::size_t{1}));
+
+    // Give each thread a contiguous run of tile pairs. Every tile pair, apart
+    // from those on the diagonal or along the edge of the matrix, moves the
+    // same number of entries, so equal counts of tile pairs yield balanced
+    // work regardless of how many tiles each grid row holds.
+    const auto range_start = [=](std::size_t thread_index) {
+        return pair_count * thread_index / thread_count;
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count - 1);
+    for (std::size_t i{1}; i < thread_count; ++i) {
+        workers.emplace_back(
+            matrix_detail::transpose_tile_pairs<Elem>,
+            m_values, m_rows, tile_size, kernels, range_start(i), range_start(i + 1)
+        );
+    }
+
+    // The calling thread processes the first range.
+    matrix_detail::transpose_tile_pairs(
+        m_values, m_rows, tile_size, kernels, range_start(0), range_start(1)
+    );
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+template<typename T>
+void Matrix<T>::cycle_transpose()
+{
+    if (m_rows == m_cols) {
+        blocked_transpose_square();
+        return;
+    }
+
+    const std::size_t size{m_rows * m_cols};
+
+    // The first and last entries never move. For single row or single column
+    // matrices, no entries move at all and only the dimensions are swapped.
+    if (m_rows > 1 && m_cols > 1) {
+        // Returns the location of the given entry after the transpose. The
+        // entry at (row, col) moves to (col, row) of the transposed matrix.
+        const auto destination = [this](std::size_t index) {
+            return (index % m_cols) * m_rows + index / m_cols;
+        };
+
+        // Tracks which entries have already been moved to their destination.
+        // std::vector<bool> packs one entry per bit.
+        std::vector<bool> visited(size);
+
+        for (std::size_t start{1}; start < size - 1; ++start) {
+            if (visited[start]) {
+                continue;
+            }
+            // Carry the entry at the start of this cycle to its destination,
+            // picking up the entry that was displaced, until the cycle closes.
+            Elem carried{m_values[start]};
+            std::size_t index{start};
+            do {
+                index = destination(index);
+                std::swap(carried, m_values[index]);
+                visited[index] = true;
+            } while (index != start);
+        }
+    }
+
+    std::swap(m_rows, m_cols);
+}
+
+template<typename T>
+void Matrix<T>::recursive_transpose_square()
+{
+    if (m_rows != m_cols) {
+        throw std::logic_error("matrix must be square");
+    }
+
+    matrix_detail::recursive_transpose_diagonal(
+        m_values,
+        m_rows,
+        0,
+        m_rows,
+        transpose_kernels::best_kernel_set()
+    );
+}
+
+template<typename T>
+void Matrix<T>::transpose_into(Matrix& dst) const
+{
+    if (&dst == this) {
+        throw std::invalid_argument("cannot transpose a matrix into itself");
+    }
+
+    if (dst.m_rows != m_cols || dst.m_cols != m_rows) {
+        dst = Matrix(m_cols, m_rows);
+    }
+
+    if (m_rows * m_cols * sizeof(Elem) >= matrix_detail::STREAMING_THRESHOLD) {
+        matrix_detail::recursive_copy_transpose<true>(
+            m_values, m_cols, dst.m_values, m_rows, 0, 0, m_rows, m_cols
+        );
+        matrix_detail::stream_fence();
+    } else {
+        matrix_detail::recursive_copy_transpose<false>(
+            m_values, m_cols, dst.m_values, m_rows, 0, 0, m_rows, m_cols
+        );
+    }
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& out, const Matrix<T>& mat)
+{
+    std::size_t col_counter{0};
+    for (const auto elem : mat) {
+        // Cycle column counter
+        col_counter = (col_counter + 1) % mat.cols();
+        // If this is the last column of a row, print a newline.
+        //
+        // Unary plus promotes character-sized integers so that they are
+        // printed as numbers.
+        out << +elem << (col_counter == 0 ? "\n" : matrix_detail::DELIM);
+    }
+    return out;
+}
+
+template<typename T>
+std::istream& operator>>(std::istream& in, Matrix<T>& mat)
+{
+    // Read character-sized integers as numbers through their promoted type.
+    using Promoted = decltype(+T{});
+
+    for (auto& elem : mat) {
+        Promoted value{};
+        if (!(in >> value)) {
+            break;
+        }
+        elem = static_cast<T>(value);
+        // Fail if the value does not fit in the entry type.
+        if (static_cast<Promoted>(elem) != value) {
+            in.setstate(std::ios_base::failbit);
+            break;
+        }
+    }
+    return in;
+}
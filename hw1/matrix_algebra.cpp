@@ -0,0 +1,448 @@
+/*
+ * ECEE 2160 Homework assignment 1 exact integer matrix algebra definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "matrix_algebra.h"
+#include "gemm.h"
+
+#include <algorithm>    // for std::copy, std::fill, std::min, std::swap_ranges, std::transform
+#include <cstdint>      // for std::int8_t, ..., std::uint64_t
+#include <limits>       // for std::numeric_limits
+#include <stdexcept>    // for std::logic_error, std::invalid_argument, std::overflow_error
+#include <utility>      // for std::move, std::swap
+#include <vector>       // for std::vector
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Columns of a modular product computed at a time. The 64-bit sums of one
+/// row of a block occupy 2 KiB.
+constexpr std::size_t MOD_COL_BLOCK{256};
+
+/// Rows of the right-hand matrix used at a time. One block of them, at most
+/// 256 KiB, stays in L2 while every row of the product is computed.
+constexpr std::size_t MOD_DEPTH_BLOCK{256};
+
+/// Rows of the right-hand matrix added by one call of the modular kernel.
+constexpr std::size_t MOD_GROUP{4};
+
+/// Entries processed per step of the modular kernel, a constant trip count
+/// that lets the compiler vectorize the kernel.
+constexpr std::size_t MOD_LANES{32};
+
+/// Columns of the pivot row applied at a time during Bareiss elimination.
+/// One block of 64-bit entries occupies 4 KiB.
+constexpr std::size_t BAREISS_COL_BLOCK{512};
+
+/**
+ * Signature of a modular kernel.
+ *
+ * A modular kernel adds `scales[g] * rows[g][j]` for g < MOD_GROUP to
+ * `sums[j]` for every j < `count`. Scales and row entries are nonnegative
+ * and less than 2^31.
+ */
+using ModKernelFn = void (*)(
+    std::uint64_t* sums,
+    const int* const* rows,
+    const std::uint32_t* scales,
+    std::size_t count
+);
+
+/**
+ * Portable modular kernel body.
+ */
+__attribute__((always_inline))
+inline void mod_kernel_body(
+    std::uint64_t* sums,
+    const int* const* rows,
+    const std::uint32_t* scales,
+    std::size_t count
+)
+{
+    const int* const row_0{rows[0]};
+    const int* const row_1{rows[1]};
+    const int* const row_2{rows[2]};
+    const int* const row_3{rows[3]};
+    const std::uint64_t scale_0{scales[0]};
+    const std::uint64_t scale_1{scales[1]};
+    const std::uint64_t scale_2{scales[2]};
+    const std::uint64_t scale_3{scales[3]};
+
+    // Widens a row entry. Entries are nonnegative, so going through
+    // std::uint32_t lets the compiler use 32 by 32 to 64-bit multiplication.
+    const auto widen = [](int entry) {
+        return std::uint64_t{static_cast<std::uint32_t>(entry)};
+    };
+
+    std::size_t j{0};
+    for (; j + MOD_LANES <= count; j += MOD_LANES) {
+        // All loads happen before all stores, so the compiler may vectorize
+        // the run without proving that `sums` and the rows do not overlap.
+        std::uint64_t run[MOD_LANES];
+        for (std::size_t l{0}; l < MOD_LANES; ++l) {
+            run[l] = sums[j + l]
+                + scale_0 * widen(row_0[j + l]) + scale_1 * widen(row_1[j + l])
+                + scale_2 * widen(row_2[j + l]) + scale_3 * widen(row_3[j + l]);
+        }
+        for (std::size_t l{0}; l < MOD_LANES; ++l) {
+            sums[j + l] = run[l];
+        }
+    }
+    for (; j < count; ++j) {
+        sums[j] += scale_0 * widen(row_0[j]) + scale_1 * widen(row_1[j])
+            + scale_2 * widen(row_2[j]) + scale_3 * widen(row_3[j]);
+    }
+}
+
+/// Modular kernel compiled for the baseline instruction set.
+void generic_mod_kernel(
+    std::uint64_t* sums,
+    const int* const* rows,
+    const std::uint32_t* scales,
+    std::size_t count
+)
+{
+    mod_kernel_body(sums, rows, scales, count);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/// Modular kernel compiled for AVX2, which provides 4-wide 32 by 32 to
+/// 64-bit unsigned multiplication (vpmuludq).
+__attribute__((target("avx2")))
+void avx2_mod_kernel(
+    std::uint64_t* sums,
+    const int* const* rows,
+    const std::uint32_t* scales,
+    std::size_t count
+)
+{
+    mod_kernel_body(sums, rows, scales, count);
+}
+#endif
+
+/**
+ * Returns the fastest modular kernel supported by the processor. The
+ * processor is only queried on the first call.
+ */
+ModKernelFn select_mod_kernel()
+{
+    static const ModKernelFn kernel = []() -> ModKernelFn {
+#if defined(__x86_64__) || defined(__i386__)
+        if (__builtin_cpu_supports("avx2")) {
+            return &avx2_mod_kernel;
+        }
+#endif
+        return &generic_mod_kernel;
+    }();
+    return kernel;
+}
+
+/**
+ * Computes c = a b modulo `modulus` for square matrices whose entries are
+ * reduced to [0, modulus).
+ */
+void multiply_mod(const IntMatrix& a, const IntMatrix& b, IntMatrix& c, std::uint32_t modulus)
+{
+    const std::size_t n{a.rows()};
+    const ModKernelFn kernel{select_mod_kernel()};
+
+    // A running sum below the modulus can absorb this many groups of
+    // products of reduced entries before it must be reduced again.
+    const std::uint64_t largest{modulus - std::uint64_t{1}};
+    const std::uint64_t group_limit{
+        largest == 0
+            ? std::numeric_limits<std::uint64_t>::max()
+            : (std::numeric_limits<std::uint64_t>::max() - largest) / (largest * largest) / MOD_GROUP
+    };
+
+    const int* const a_values{a.begin()};
+    const int* const b_values{b.begin()};
+    int* const c_values{c.begin()};
+    std::uint64_t sums[MOD_COL_BLOCK];
+
+    for (std::size_t jc{0}; jc < n; jc += MOD_COL_BLOCK) {
+        const std::size_t nc{std::min(MOD_COL_BLOCK, n - jc)};
+
+        for (std::size_t pc{0}; pc < n; pc += MOD_DEPTH_BLOCK) {
+            const std::size_t kc{std::min(MOD_DEPTH_BLOCK, n - pc)};
+
+            for (std::size_t i{0}; i < n; ++i) {
+                const int* const a_row{a_values + i * n + pc};
+                std::fill(sums, sums + nc, std::uint64_t{0});
+
+                std::uint64_t groups{0};
+                for (std::size_t k{0}; k < kc; k += MOD_GROUP) {
+                    // A partial group is padded with zero scales.
+                    const int* rows[MOD_GROUP];
+                    std::uint32_t scales[MOD_GROUP];
+                    for (std::size_t g{0}; g < MOD_GROUP; ++g) {
+                        const bool inside{k + g < kc};
+                        rows[g] = b_values + (pc + (inside ? k + g : k)) * n + jc;
+                        scales[g] = inside ? static_cast<std::uint32_t>(a_row[k + g]) : 0;
+                    }
+                    kernel(sums, rows, scales, nc);
+
+                    if (++groups == group_limit) {
+                        for (std::size_t j{0}; j < nc; ++j) {
+                            sums[j] %= modulus;
+                        }
+                        groups = 0;
+                    }
+                }
+
+                // Fold this block of the depth into the destination.
+                int* const c_row{c_values + i * n + jc};
+                for (std::size_t j{0}; j < nc; ++j) {
+                    std::uint64_t entry{sums[j] % modulus};
+                    if (pc != 0) {
+                        entry += static_cast<std::uint32_t>(c_row[j]);
+                        entry -= entry >= modulus ? modulus : 0;
+                    }
+                    c_row[j] = static_cast<int>(entry);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Returns an identity matrix of the given size.
+ */
+template<typename T>
+Matrix<T> identity(std::size_t size)
+{
+    Matrix<T> result(size, size);
+    std::fill(result.begin(), result.end(), T{0});
+    for (std::size_t i{0}; i < size; ++i) {
+        result(i, i) = T{1};
+    }
+    return result;
+}
+
+/**
+ * Raises a square matrix to the given positive power by repeated squaring.
+ *
+ * @param base Matrix to raise.
+ * @param product Function computing `c = a b` for distinct matrices.
+ */
+template<typename T, typename F>
+Matrix<T> power_by_squaring(Matrix<T> base, std::uint64_t exponent, const F& product)
+{
+    const std::size_t n{base.rows()};
+    Matrix<T> result(n, n);
+    Matrix<T> scratch(n, n);
+
+    // The result is only materialized at the lowest set bit of the exponent,
+    // which saves a multiplication by the identity.
+    bool have_result{false};
+    while (true) {
+        if ((exponent & 1u) != 0) {
+            if (have_result) {
+                product(result, base, scratch);
+                std::swap(result, scratch);
+            } else {
+                std::copy(base.begin(), base.end(), result.begin());
+                have_result = true;
+            }
+        }
+        exponent >>= 1u;
+        if (exponent == 0) {
+            return result;
+        }
+        product(base, base, scratch);
+        std::swap(base, scratch);
+    }
+}
+
+/**
+ * Precomputed exact division by a fixed nonzero divisor.
+ *
+ * A divisor d = d' 2^s with d' odd divides x exactly if and only if x / d
+ * equals (x / 2^s) times the inverse of d' modulo 2^64. Both steps are exact
+ * for multiples of d, and cost one shift and one multiplication.
+ */
+class ExactDivisor {
+    /// Trailing zero bits of the divisor.
+    unsigned m_shift;
+
+    /// Inverse of the odd part of the divisor modulo 2^64.
+    std::uint64_t m_inverse;
+
+  public:
+    explicit ExactDivisor(std::int64_t divisor)
+        : m_shift{static_cast<unsigned>(__builtin_ctzll(static_cast<std::uint64_t>(divisor)))},
+          m_inverse{static_cast<std::uint64_t>(divisor >> m_shift)}
+    {
+        // Newton's iteration doubles the number of correct low bits of the
+        // inverse. Every odd number is its own inverse modulo 8, so five
+        // iterations give 3 * 2^5 >= 64 correct bits.
+        const std::uint64_t odd{m_inverse};
+        for (int i{0}; i < 5; ++i) {
+            m_inverse *= 2 - odd * m_inverse;
+        }
+    }
+
+    /**
+     * Returns the quotient of the given exact multiple of the divisor.
+     */
+    std::int64_t divide(std::int64_t multiple) const
+    {
+        return static_cast<std::int64_t>(static_cast<std::uint64_t>(multiple >> m_shift) * m_inverse);
+    }
+};
+
+/// Integer type wide enough for the product of two 64-bit integers.
+__extension__ using Wide = __int128;
+
+/**
+ * Computes one Bareiss update, (pivot * entry - left * above) / previous,
+ * for the rare case where the numerator does not fit in 64 bits.
+ */
+std::int64_t wide_bareiss_update(
+    std::int64_t pivot,
+    std::int64_t entry,
+    std::int64_t left,
+    std::int64_t above,
+    std::int64_t previous
+)
+{
+    const Wide quotient{(Wide{pivot} * entry - Wide{left} * above) / previous};
+    if (quotient < std::numeric_limits<std::int64_t>::min()
+        || quotient > std::numeric_limits<std::int64_t>::max()) {
+        throw std::overflow_error("determinant intermediate does not fit in 64 bits");
+    }
+    return static_cast<std::int64_t>(quotient);
+}
+
+} // end namespace
+
+template<typename T>
+Matrix<T> power(const Matrix<T>& mat, std::uint64_t exponent)
+{
+    if (mat.rows() != mat.cols()) {
+        throw std::logic_error("matrix must be square");
+    }
+    if (exponent == 0) {
+        return identity<T>(mat.rows());
+    }
+
+    Matrix<T> base(mat.rows(), mat.cols());
+    std::copy(mat.begin(), mat.end(), base.begin());
+    const auto product = [](const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c) {
+        multiply(a, b, c);
+    };
+    return power_by_squaring(std::move(base), exponent, product);
+}
+
+IntMatrix power_mod(const IntMatrix& mat, std::uint64_t exponent, std::uint32_t modulus)
+{
+    if (mat.rows() != mat.cols()) {
+        throw std::logic_error("matrix must be square");
+    }
+    if (modulus == 0 || modulus > MAX_POWER_MODULUS) {
+        throw std::invalid_argument("modulus must be between 1 and 2^31");
+    }
+
+    if (exponent == 0) {
+        IntMatrix result{identity<int>(mat.rows())};
+        if (modulus == 1) {
+            std::fill(result.begin(), result.end(), 0);
+        }
+        return result;
+    }
+
+    // Reduce the entries to their nonnegative residues.
+    IntMatrix base(mat.rows(), mat.cols());
+    const auto signed_modulus = static_cast<std::int64_t>(modulus);
+    std::transform(mat.begin(), mat.end(), base.begin(), [signed_modulus](int entry) {
+        const std::int64_t residue{entry % signed_modulus};
+        return static_cast<int>(residue < 0 ? residue + signed_modulus : residue);
+    });
+
+    const auto product = [modulus](const IntMatrix& a, const IntMatrix& b, IntMatrix& c) {
+        multiply_mod(a, b, c, modulus);
+    };
+    return power_by_squaring(std::move(base), exponent, product);
+}
+
+std::int64_t determinant(const IntMatrix& mat)
+{
+    if (mat.rows() != mat.cols()) {
+        throw std::logic_error("matrix must be square");
+    }
+
+    const std::size_t n{mat.rows()};
+    if (n == 0) {
+        return 1;
+    }
+
+    std::vector<std::int64_t> work(mat.begin(), mat.end());
+    bool negate{false};
+    std::int64_t previous{1};
+
+    for (std::size_t k{0}; k + 1 < n; ++k) {
+        std::int64_t* const pivot_row{work.data() + k * n};
+
+        // Swap a row with a nonzero entry into the pivot position, which
+        // negates the determinant.
+        if (pivot_row[k] == 0) {
+            std::size_t swap_row{k + 1};
+            while (swap_row < n && work[swap_row * n + k] == 0) {
+                ++swap_row;
+            }
+            if (swap_row == n) {
+                return 0;
+            }
+            std::swap_ranges(pivot_row + k, pivot_row + n, work.data() + swap_row * n + k);
+            negate = !negate;
+        }
+
+        const std::int64_t pivot{pivot_row[k]};
+        const ExactDivisor divisor(previous);
+
+        for (std::size_t jb{k + 1}; jb < n; jb += BAREISS_COL_BLOCK) {
+            const std::size_t j_end{std::min(jb + BAREISS_COL_BLOCK, n)};
+            for (std::size_t i{k + 1}; i < n; ++i) {
+                std::int64_t* const row{work.data() + i * n};
+                const std::int64_t left{row[k]};
+                for (std::size_t j{jb}; j < j_end; ++j) {
+                    // The numerator usually fits in 64 bits, and then the
+                    // exact division is a shift and a multiplication.
+                    std::int64_t scaled;
+                    std::int64_t eliminated;
+                    std::int64_t numerator;
+                    if (__builtin_mul_overflow(pivot, row[j], &scaled)
+                        || __builtin_mul_overflow(left, pivot_row[j], &eliminated)
+                        || __builtin_sub_overflow(scaled, eliminated, &numerator)) {
+                        row[j] = wide_bareiss_update(pivot, row[j], left, pivot_row[j], previous);
+                    } else {
+                        row[j] = divisor.divide(numerator);
+                    }
+                }
+            }
+        }
+        previous = pivot;
+    }
+
+    const std::int64_t result{work[n * n - 1]};
+    if (negate && result == std::numeric_limits<std::int64_t>::min()) {
+        throw std::overflow_error("determinant does not fit in 64 bits");
+    }
+    return negate ? -result : result;
+}
+
+// Explicit instantiations for the supported entry types.
+template Matrix<std::int8_t> power(const Matrix<std::int8_t>&, std::uint64_t);
+template Matrix<std::int16_t> power(const Matrix<std::int16_t>&, std::uint64_t);
+template Matrix<std::int32_t> power(const Matrix<std::int32_t>&, std::uint64_t);
+template Matrix<std::int64_t> power(const Matrix<std::int64_t>&, std::uint64_t);
+template Matrix<std::uint8_t> power(const Matrix<std::uint8_t>&, std::uint64_t);
+template Matrix<std::uint16_t> power(const Matrix<std::uint16_t>&, std::uint64_t);
+template Matrix<std::uint32_t> power(const Matrix<std::uint32_t>&, std::uint64_t);
+template Matrix<std::uint64_t> power(const Matrix<std::uint64_t>&, std::uint64_t);
+template Matrix<float> power(const Matrix<float>&, std::uint64_t);
+template Matrix<double> power(const Matrix<double>&, std::uint64_t);
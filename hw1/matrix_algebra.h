@@ -0,0 +1,79 @@
+/*
+ * ECEE 2160 Homework assignment 1 exact integer matrix algebra declarations.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - E. H. Bareiss, "Sylvester's identity and multistep integer-preserving
+ *    Gaussian elimination," Math. Comp., vol. 22, no. 103, 1968.
+ *  - T. Granlund and P. L. Montgomery, "Division by invariant integers using
+ *    multiplication," in Proc. PLDI, 1994. (section 9, exact division)
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_MATRIX_ALGEBRA_H
+#define ECEE_2160_HOMEWORK_MATRIX_ALGEBRA_H
+
+#include "matrix.h"
+
+#include <cstdint>      // for std::int64_t, std::uint32_t, std::uint64_t
+
+/**
+ * Returns the given square matrix raised to the given power.
+ *
+ * The power is computed by repeated squaring with the blocked multiply()
+ * from gemm.h, so it takes at most 2 log2(exponent) products. Each product
+ * narrows its entries to the entry type exactly as multiply() does, so
+ * integer entries wrap once they exceed the range of the entry type. Use
+ * power_mod() to keep integer entries in range.
+ *
+ * This function raises std::logic_error if the matrix is not square.
+ *
+ * This function is explicitly instantiated in matrix_algebra.cpp for signed
+ * and unsigned integers of 8, 16, 32 and 64 bits, `float` and `double`.
+ *
+ * @param exponent Power to raise the matrix to. A power of 0 gives the
+ *                 identity matrix.
+ */
+template<typename T>
+Matrix<T> power(const Matrix<T>& mat, std::uint64_t exponent);
+
+/// Largest modulus accepted by power_mod(), so that every reduced entry
+/// fits in an IntMatrix entry.
+constexpr std::uint32_t MAX_POWER_MODULUS{std::uint32_t{1} << 31u};
+
+/**
+ * Returns the given square matrix raised to the given power, with every
+ * entry reduced modulo `modulus` to the range [0, modulus).
+ *
+ * Products are computed exactly by a blocked kernel that sums products of
+ * reduced entries in 64-bit integers, and reduces the sums only as often as
+ * needed to prevent overflow. Negative entries of the matrix are reduced
+ * to their nonnegative residues first.
+ *
+ * This function raises std::logic_error if the matrix is not square, and
+ * std::invalid_argument if the modulus is 0 or exceeds MAX_POWER_MODULUS.
+ */
+IntMatrix power_mod(const IntMatrix& mat, std::uint64_t exponent, std::uint32_t modulus);
+
+/**
+ * Returns the determinant of the given square matrix, computed exactly.
+ *
+ * The determinant is computed by fraction-free Bareiss elimination. Every
+ * intermediate entry is itself the determinant of a submatrix, so all
+ * divisions are exact and no rational arithmetic is needed. Each elimination
+ * step divides by the previous pivot, which is done by multiplying with its
+ * inverse modulo 2^64 rather than by division instructions. The rows below
+ * the pivot are updated one block of columns at a time, so the block of the
+ * pivot row stays in cache while it is applied to every row.
+ *
+ * This function raises std::logic_error if the matrix is not square, and
+ * std::overflow_error if the determinant or an intermediate entry does not
+ * fit in 64 bits. The result is never silently wrong.
+ */
+std::int64_t determinant(const IntMatrix& mat);
+
+#endif //ECEE_2160_HOMEWORK_MATRIX_ALGEBRA_H
@@ -0,0 +1,180 @@
+/*
+ * ECEE 2160 Homework assignment 1 batched small matrix declarations.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - https://en.wikipedia.org/wiki/AoS_and_SoA
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_MATRIX_BATCH_H
+#define ECEE_2160_HOMEWORK_MATRIX_BATCH_H
+
+#include "fixed_matrix.h"
+#include "matrix.h"
+
+#include <cstddef>      // for std::size_t
+#include <type_traits>  // for std::enable_if_t, std::is_arithmetic
+
+/**
+ * A batch of equally sized small matrices stored in structure-of-arrays
+ * layout.
+ *
+ * Entry (i, j) of every matrix in the batch is stored contiguously in a
+ * plane of its own, so an operation applied to all matrices becomes a loop
+ * over the matrices for each entry position. Such loops are vectorized by
+ * the compiler across matrices, which is far more effective than
+ * vectorizing within a matrix of 9 or 16 entries. Each plane starts on a
+ * matrix_storage::ALIGNMENT boundary.
+ *
+ * Like Matrix, batches may be moved but not copied.
+ *
+ * @tparam T Data type of matrix entries.
+ * @tparam R The number of rows of each matrix.
+ * @tparam C The number of columns of each matrix.
+ */
+template<typename T, std::size_t R, std::size_t C>
+class MatrixBatch {
+    static_assert(std::is_arithmetic<T>::value, "MatrixBatch entries must be arithmetic.");
+    static_assert(R > 0 && C > 0, "MatrixBatch dimensions must be nonzero.");
+
+    /// The number of matrices in this batch.
+    std::size_t m_count;
+
+    /// Distance between the starts of consecutive planes, in entries.
+    std::size_t m_stride;
+
+    /// The R * C planes of entries, in row-major order of entry positions.
+    T* m_values;
+
+  public:
+    /// Data type for matrix entries.
+    using Elem = T;
+
+    /**
+     * Constructs a batch of the given number of matrices with uninitialized
+     * entries.
+     *
+     * @param count The number of matrices.
+     */
+    explicit MatrixBatch(std::size_t count);
+
+    ~MatrixBatch();
+
+    /*
+     * Copying is disallowed so that deep copies of large batches cannot
+     * happen by accident.
+     */
+    MatrixBatch(const MatrixBatch&) = delete;
+
+    MatrixBatch& operator=(const MatrixBatch&) = delete;
+
+    /*
+     * Moves transfer ownership of the entries. The moved-from batch is left
+     * empty.
+     */
+    MatrixBatch(MatrixBatch&& other) noexcept;
+
+    MatrixBatch& operator=(MatrixBatch&& other) noexcept;
+
+    /**
+     * Returns the number of matrices in the batch.
+     */
+    std::size_t count() const { return m_count; }
+
+    /**
+     * Returns the number of rows of each matrix.
+     */
+    static constexpr std::size_t rows() { return R; }
+
+    /**
+     * Returns the number of columns of each matrix.
+     */
+    static constexpr std::size_t cols() { return C; }
+
+    /**
+     * Returns the plane holding entry (row, col) of every matrix, indexed by
+     * matrix. Positions are not checked.
+     */
+    Elem* plane(std::size_t row, std::size_t col) { return m_values + (row * C + col) * m_stride; }
+
+    const Elem* plane(std::size_t row, std::size_t col) const
+    {
+        return m_values + (row * C + col) * m_stride;
+    }
+
+    /**
+     * Returns entry (row, col) of the matrix at the given position in the
+     * batch.
+     *
+     * This function raises std::out_of_range if any index is out of range.
+     */
+    Elem& at(std::size_t matrix, std::size_t row, std::size_t col);
+
+    const Elem& at(std::size_t matrix, std::size_t row, std::size_t col) const;
+
+    /**
+     * Returns a copy of the matrix at the given position in the batch.
+     *
+     * This function raises std::out_of_range if the position is out of range.
+     */
+    FixedMatrix<T, R, C> get(std::size_t matrix) const;
+
+    /**
+     * Replaces the matrix at the given position in the batch.
+     *
+     * This function raises std::out_of_range if the position is out of range.
+     */
+    void set(std::size_t matrix, const FixedMatrix<T, R, C>& mat);
+
+    /**
+     * Sets every entry of every matrix to the given value.
+     */
+    void fill(Elem value);
+
+    /**
+     * Returns a new batch holding the transpose of every matrix.
+     *
+     * In SoA layout the transpose only renames planes, so each plane is
+     * copied once with a contiguous copy.
+     */
+    MatrixBatch<T, C, R> transpose() const;
+
+    /**
+     * Transposes every matrix in-place by swapping the planes above the
+     * diagonal with those below it.
+     */
+    template<std::size_t N = R, typename = std::enable_if_t<N == C>>
+    void transpose_square();
+};
+
+/**
+ * Multiplies each pair of matrices at the same position of `a` and `b`,
+ * storing the product in the same position of `c`.
+ *
+ * Each output plane is computed for a chunk of matrices at a time, so the
+ * innermost loops run across matrices over contiguous planes and vectorize.
+ * Integer products wrap modulo 2^N for N-bit entries, giving the same
+ * results as multiply() on Matrix.
+ *
+ * This function raises std::invalid_argument if the batches do not hold the
+ * same number of matrices, or if `c` is `a` or `b`.
+ *
+ * @param a Batch of left operands.
+ * @param b Batch of right operands.
+ * @param c Batch receiving the products.
+ */
+template<typename T, std::size_t R, std::size_t K, std::size_t C>
+void multiply(
+    const MatrixBatch<T, R, K>& a,
+    const MatrixBatch<T, K, C>& b,
+    MatrixBatch<T, R, C>& c
+);
+
+#include "matrix_batch.tpp"
+
+#endif //ECEE_2160_HOMEWORK_MATRIX_BATCH_H
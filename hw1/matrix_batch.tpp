@@ -0,0 +1,270 @@
+/*
+ * ECEE 2160 Homework assignment 1 batched small matrix definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include <algorithm>    // for std::copy, std::fill, std::min
+#include <limits>       // for std::numeric_limits
+#include <new>          // for std::bad_array_new_length
+#include <stdexcept>    // for std::out_of_range, std::invalid_argument
+#include <utility>      // for std::exchange, std::index_sequence
+
+namespace matrix_batch_detail {
+
+/// Number of matrices whose products are accumulated together by multiply().
+/// The accumulators of one chunk of 4-byte entries fill 256 bytes, which
+/// stays in registers or L1 while every term is added.
+constexpr std::size_t CHUNK{64};
+
+/**
+ * Type in which products of entries of type T are accumulated.
+ *
+ * Integers are accumulated as unsigned integers of at least the width of
+ * int, so that overflow wraps instead of being undefined, and so that
+ * narrow entries are not promoted to signed int before being multiplied.
+ */
+template<typename T, bool = std::is_integral<T>::value>
+struct WrapType {
+    using type = T;
+};
+
+template<typename T>
+struct WrapType<T, true> {
+    using type = std::conditional_t<
+        (sizeof(T) < sizeof(unsigned int)),
+        unsigned int,
+        std::make_unsigned_t<T>
+    >;
+};
+
+/**
+ * Returns the wrapped product of two entries.
+ */
+template<typename Wrap, typename T>
+inline Wrap wrap_product(T lhs, T rhs)
+{
+    return static_cast<Wrap>(static_cast<Wrap>(lhs) * static_cast<Wrap>(rhs));
+}
+
+/**
+ * Multiplies the matrices at positions [first, first + len) of the given
+ * batches, where len is at most CHUNK.
+ *
+ * For each output entry, the inner product over the K planes of `a` and `b`
+ * is expanded over an index sequence, so the loop across matrices is the only
+ * loop left. Its results go to a local buffer that the compiler can prove
+ * does not alias the operands, and are then copied to the output plane.
+ *
+ * @tparam Len The chunk length if known at compile time, otherwise 0. A
+ *             constant trip count lets the compiler vectorize the loops
+ *             without a scalar remainder.
+ */
+template<std::size_t Len, typename T, std::size_t R, std::size_t K, std::size_t C, std::size_t... Ks>
+void multiply_chunk(
+    const MatrixBatch<T, R, K>& a,
+    const MatrixBatch<T, K, C>& b,
+    MatrixBatch<T, R, C>& c,
+    std::size_t first,
+    std::size_t len,
+    std::index_sequence<Ks...>
+)
+{
+    using Wrap = typename WrapType<T>::type;
+
+    if (Len != 0) {
+        len = Len;
+    }
+    Wrap acc[CHUNK];
+
+    for (std::size_t i_row{0}; i_row < R; ++i_row) {
+        for (std::size_t i_col{0}; i_col < C; ++i_col) {
+            const T* const lhs[K]{(a.plane(i_row, Ks) + first)...};
+            const T* const rhs[K]{(b.plane(Ks, i_col) + first)...};
+            for (std::size_t n{0}; n < len; ++n) {
+                acc[n] = static_cast<Wrap>((Wrap{0} + ... + wrap_product<Wrap>(lhs[Ks][n], rhs[Ks][n])));
+            }
+
+            T* out{c.plane(i_row, i_col) + first};
+            for (std::size_t n{0}; n < len; ++n) {
+                out[n] = static_cast<T>(acc[n]);
+            }
+        }
+    }
+}
+
+} // end namespace matrix_batch_detail
+
+template<typename T, std::size_t R, std::size_t C>
+MatrixBatch<T, R, C>::MatrixBatch(std::size_t count)
+    : m_count{count},
+      m_stride{0},
+      m_values{nullptr}
+{
+    // Round the plane length up to a whole number of alignment units so that
+    // every plane starts aligned.
+    constexpr std::size_t unit{matrix_storage::ALIGNMENT / sizeof(T)};
+    if (count > std::numeric_limits<std::size_t>::max() - unit) {
+        throw std::bad_array_new_length();
+    }
+    m_stride = (count + unit - 1) / unit * unit;
+
+    if (m_stride > std::numeric_limits<std::size_t>::max() / sizeof(T) / (R * C)) {
+        throw std::bad_array_new_length();
+    }
+    m_values = static_cast<T*>(
+        matrix_storage::allocate(m_stride * R * C * sizeof(T), PagePolicy::Normal)
+    );
+}
+
+template<typename T, std::size_t R, std::size_t C>
+MatrixBatch<T, R, C>::~MatrixBatch()
+{
+    matrix_storage::deallocate(m_values);
+    m_values = nullptr;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+MatrixBatch<T, R, C>::MatrixBatch(MatrixBatch&& other) noexcept
+    : m_count{std::exchange(other.m_count, 0)},
+      m_stride{std::exchange(other.m_stride, 0)},
+      m_values{std::exchange(other.m_values, nullptr)} {}
+
+template<typename T, std::size_t R, std::size_t C>
+MatrixBatch<T, R, C>& MatrixBatch<T, R, C>::operator=(MatrixBatch&& other) noexcept
+{
+    if (this != &other) {
+        // Release our entries before taking ownership of the other batch's.
+        matrix_storage::deallocate(m_values);
+        m_count = std::exchange(other.m_count, 0);
+        m_stride = std::exchange(other.m_stride, 0);
+        m_values = std::exchange(other.m_values, nullptr);
+    }
+    return *this;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+typename MatrixBatch<T, R, C>::Elem&
+MatrixBatch<T, R, C>::at(std::size_t matrix, std::size_t row, std::size_t col)
+{
+    if (matrix >= m_count || row >= R || col >= C) {
+        throw std::out_of_range("invalid matrix index");
+    }
+    return plane(row, col)[matrix];
+}
+
+template<typename T, std::size_t R, std::size_t C>
+const typename MatrixBatch<T, R, C>::Elem&
+MatrixBatch<T, R, C>::at(std::size_t matrix, std::size_t row, std::size_t col) const
+{
+    if (matrix >= m_count || row >= R || col >= C) {
+        throw std::out_of_range("invalid matrix index");
+    }
+    return plane(row, col)[matrix];
+}
+
+template<typename T, std::size_t R, std::size_t C>
+FixedMatrix<T, R, C> MatrixBatch<T, R, C>::get(std::size_t matrix) const
+{
+    if (matrix >= m_count) {
+        throw std::out_of_range("invalid matrix index");
+    }
+
+    FixedMatrix<T, R, C> mat;
+    for (std::size_t i_row{0}; i_row < R; ++i_row) {
+        for (std::size_t i_col{0}; i_col < C; ++i_col) {
+            mat(i_row, i_col) = plane(i_row, i_col)[matrix];
+        }
+    }
+    return mat;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+void MatrixBatch<T, R, C>::set(std::size_t matrix, const FixedMatrix<T, R, C>& mat)
+{
+    if (matrix >= m_count) {
+        throw std::out_of_range("invalid matrix index");
+    }
+
+    for (std::size_t i_row{0}; i_row < R; ++i_row) {
+        for (std::size_t i_col{0}; i_col < C; ++i_col) {
+            plane(i_row, i_col)[matrix] = mat(i_row, i_col);
+        }
+    }
+}
+
+template<typename T, std::size_t R, std::size_t C>
+void MatrixBatch<T, R, C>::fill(Elem value)
+{
+    for (std::size_t i_row{0}; i_row < R; ++i_row) {
+        for (std::size_t i_col{0}; i_col < C; ++i_col) {
+            std::fill(plane(i_row, i_col), plane(i_row, i_col) + m_count, value);
+        }
+    }
+}
+
+template<typename T, std::size_t R, std::size_t C>
+MatrixBatch<T, C, R> MatrixBatch<T, R, C>::transpose() const
+{
+    MatrixBatch<T, C, R> result(m_count);
+    for (std::size_t i_row{0}; i_row < R; ++i_row) {
+        for (std::size_t i_col{0}; i_col < C; ++i_col) {
+            std::copy(plane(i_row, i_col), plane(i_row, i_col) + m_count, result.plane(i_col, i_row));
+        }
+    }
+    return result;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+template<std::size_t N, typename>
+void MatrixBatch<T, R, C>::transpose_square()
+{
+    constexpr std::size_t chunk_size{matrix_batch_detail::CHUNK};
+    Elem buffer[chunk_size];
+
+    for (std::size_t i_row{1}; i_row < R; ++i_row) {
+        for (std::size_t i_col{0}; i_col < i_row; ++i_col) {
+            Elem* const lower{plane(i_row, i_col)};
+            Elem* const upper{plane(i_col, i_row)};
+            // Swap the planes a chunk at a time through a local buffer, so
+            // that each step is a plain block copy.
+            for (std::size_t first{0}; first < m_count; first += chunk_size) {
+                const std::size_t len{std::min(chunk_size, m_count - first)};
+                std::copy(lower + first, lower + first + len, buffer);
+                std::copy(upper + first, upper + first + len, lower + first);
+                std::copy(buffer, buffer + len, upper + first);
+            }
+        }
+    }
+}
+
+template<typename T, std::size_t R, std::size_t K, std::size_t C>
+void multiply(
+    const MatrixBatch<T, R, K>& a,
+    const MatrixBatch<T, K, C>& b,
+    MatrixBatch<T, R, C>& c
+)
+{
+    constexpr std::size_t chunk_size{matrix_batch_detail::CHUNK};
+    constexpr auto inner = std::make_index_sequence<K>{};
+
+    if (a.count() != b.count() || a.count() != c.count()) {
+        throw std::invalid_argument("batch sizes do not agree");
+    }
+    if (static_cast<const void*>(&c) == static_cast<const void*>(&a)
+        || static_cast<const void*>(&c) == static_cast<const void*>(&b)) {
+        throw std::invalid_argument("product cannot be stored in an operand");
+    }
+
+    const std::size_t count{a.count()};
+    const std::size_t full_end{count - count % chunk_size};
+
+    for (std::size_t first{0}; first < full_end; first += chunk_size) {
+        matrix_batch_detail::multiply_chunk<chunk_size>(a, b, c, first, chunk_size, inner);
+    }
+    if (full_end != count) {
+        matrix_batch_detail::multiply_chunk<0>(a, b, c, full_end, count - full_end, inner);
+    }
+}
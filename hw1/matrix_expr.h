@@ -0,0 +1,297 @@
+/*
+ * ECEE 2160 Homework assignment 1 matrix expression templates.
+ *
+ * This header is included by matrix.h and should not be included directly.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - https://en.wikipedia.org/wiki/Expression_templates
+ *  - https://en.cppreference.com/w/cpp/language/crtp
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_MATRIX_EXPR_H
+#define ECEE_2160_HOMEWORK_MATRIX_EXPR_H
+
+#include <cstddef>      // for std::size_t
+#include <functional>   // for std::less
+#include <stdexcept>    // for std::invalid_argument
+#include <type_traits>  // for std::enable_if_t, std::is_arithmetic
+
+template<typename T>
+class Matrix;
+
+namespace matrix_expr_detail {
+
+/**
+ * Returns `true` if the byte ranges [a_first, a_last) and [b_first, b_last)
+ * overlap. std::less is used since it provides a total order over pointers
+ * into unrelated objects.
+ */
+inline bool overlaps(const void* a_first, const void* a_last, const void* b_first, const void* b_last)
+{
+    const std::less<const void*> less;
+    return less(a_first, b_last) && less(b_first, a_last);
+}
+
+} // end namespace matrix_expr_detail
+
+/**
+ * Base class of lazy matrix expressions.
+ *
+ * Expressions record the operations applied to their operands without
+ * computing any entries. Entries are computed one at a time when an
+ * expression is assigned to a Matrix, so a chain of element-wise operations
+ * is evaluated in a single pass without intermediate matrices.
+ *
+ * Expressions refer to the entries of their Matrix operands without owning
+ * them. An expression must therefore be evaluated before any of its operands
+ * is destroyed, which always holds when the expression is assigned in the
+ * same statement that builds it.
+ *
+ * Each expression type E provides:
+ *  - rows() and cols(),
+ *  - operator()(row, col) returning the entry at the given position,
+ *  - at(index) returning the entry at the given row-major index, which is
+ *    only valid when E::is_linear is true,
+ *  - aliases(first, last) returning true if the expression may read any
+ *    byte in the range [first, last).
+ *
+ * @tparam E The derived expression type.
+ */
+template<typename E>
+class MatrixExpr {
+  public:
+    /// Returns this expression as its derived type.
+    const E& self() const { return static_cast<const E&>(*this); }
+
+    std::size_t rows() const { return self().rows(); }
+
+    std::size_t cols() const { return self().cols(); }
+};
+
+/**
+ * Expression referring to the entries of a matrix.
+ */
+template<typename T>
+class MatrixLeaf : public MatrixExpr<MatrixLeaf<T>> {
+    const T* m_values;
+    std::size_t m_rows;
+    std::size_t m_cols;
+
+  public:
+    using value_type = T;
+
+    /// Entries are stored in row-major order.
+    static constexpr bool is_linear{true};
+
+    explicit MatrixLeaf(const Matrix<T>& mat)
+        : m_values{mat.begin()}, m_rows{mat.rows()}, m_cols{mat.cols()} {}
+
+    std::size_t rows() const { return m_rows; }
+
+    std::size_t cols() const { return m_cols; }
+
+    T operator()(std::size_t row, std::size_t col) const { return m_values[row * m_cols + col]; }
+
+    T at(std::size_t index) const { return m_values[index]; }
+
+    bool aliases(const void* first, const void* last) const
+    {
+        return matrix_expr_detail::overlaps(m_values, m_values + m_rows * m_cols, first, last);
+    }
+};
+
+/**
+ * Expression for the transpose of another expression.
+ */
+template<typename E>
+class TransposeExpr : public MatrixExpr<TransposeExpr<E>> {
+    E m_expr;
+
+  public:
+    using value_type = typename E::value_type;
+
+    /// Row-major traversal of a transpose is a column-major traversal of
+    /// its operand, so entries cannot be addressed by a single index.
+    static constexpr bool is_linear{false};
+
+    explicit TransposeExpr(const E& expr) : m_expr{expr} {}
+
+    std::size_t rows() const { return m_expr.cols(); }
+
+    std::size_t cols() const { return m_expr.rows(); }
+
+    value_type operator()(std::size_t row, std::size_t col) const { return m_expr(col, row); }
+
+    value_type at(std::size_t) const = delete;
+
+    bool aliases(const void* first, const void* last) const { return m_expr.aliases(first, last); }
+};
+
+/**
+ * Expression applying a binary operation to corresponding entries of two
+ * expressions of equal dimensions.
+ */
+template<typename L, typename R, typename Op>
+class BinaryExpr : public MatrixExpr<BinaryExpr<L, R, Op>> {
+    L m_lhs;
+    R m_rhs;
+
+  public:
+    using value_type = decltype(Op::apply(
+        std::declval<typename L::value_type>(),
+        std::declval<typename R::value_type>()
+    ));
+
+    static constexpr bool is_linear{L::is_linear && R::is_linear};
+
+    /**
+     * @throws std::invalid_argument if the operands have different
+     *         dimensions.
+     */
+    BinaryExpr(const L& lhs, const R& rhs) : m_lhs{lhs}, m_rhs{rhs}
+    {
+        if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols()) {
+            throw std::invalid_argument("matrix dimensions do not agree");
+        }
+    }
+
+    std::size_t rows() const { return m_lhs.rows(); }
+
+    std::size_t cols() const { return m_lhs.cols(); }
+
+    value_type operator()(std::size_t row, std::size_t col) const
+    {
+        return Op::apply(m_lhs(row, col), m_rhs(row, col));
+    }
+
+    value_type at(std::size_t index) const { return Op::apply(m_lhs.at(index), m_rhs.at(index)); }
+
+    bool aliases(const void* first, const void* last) const
+    {
+        return m_lhs.aliases(first, last) || m_rhs.aliases(first, last);
+    }
+};
+
+/**
+ * Expression multiplying every entry of an expression by a scalar.
+ */
+template<typename E, typename S>
+class ScaleExpr : public MatrixExpr<ScaleExpr<E, S>> {
+    E m_expr;
+    S m_scalar;
+
+  public:
+    using value_type = decltype(std::declval<typename E::value_type>() * std::declval<S>());
+
+    static constexpr bool is_linear{E::is_linear};
+
+    ScaleExpr(const E& expr, S scalar) : m_expr{expr}, m_scalar{scalar} {}
+
+    std::size_t rows() const { return m_expr.rows(); }
+
+    std::size_t cols() const { return m_expr.cols(); }
+
+    value_type operator()(std::size_t row, std::size_t col) const { return m_expr(row, col) * m_scalar; }
+
+    value_type at(std::size_t index) const { return m_expr.at(index) * m_scalar; }
+
+    bool aliases(const void* first, const void* last) const { return m_expr.aliases(first, last); }
+};
+
+namespace matrix_expr_detail {
+
+/// Entry-wise addition.
+struct Plus {
+    template<typename A, typename B>
+    static auto apply(A a, B b) { return a + b; }
+};
+
+/// Entry-wise subtraction.
+struct Minus {
+    template<typename A, typename B>
+    static auto apply(A a, B b) { return a - b; }
+};
+
+/*
+ * Conversions from operands to expressions. Matrices are wrapped in leaves,
+ * and expressions are used as they are.
+ */
+template<typename T>
+MatrixLeaf<T> to_expr(const Matrix<T>& mat) { return MatrixLeaf<T>{mat}; }
+
+template<typename E>
+const E& to_expr(const MatrixExpr<E>& expr) { return expr.self(); }
+
+/// Trait identifying matrices and matrix expressions.
+template<typename X>
+struct IsOperand : std::is_base_of<MatrixExpr<X>, X> {};
+
+template<typename T>
+struct IsOperand<Matrix<T>> : std::true_type {};
+
+/// Expression type produced for the given operand type.
+template<typename X>
+using ExprOf = std::decay_t<decltype(to_expr(std::declval<const X&>()))>;
+
+template<typename L, typename R>
+using EnableIfOperands = std::enable_if_t<IsOperand<L>::value && IsOperand<R>::value>;
+
+template<typename X, typename S>
+using EnableIfScalable = std::enable_if_t<IsOperand<X>::value && std::is_arithmetic<S>::value>;
+
+} // end namespace matrix_expr_detail
+
+/**
+ * Returns a lazy expression for the entry-wise sum of two matrices or
+ * expressions.
+ */
+template<typename L, typename R, typename = matrix_expr_detail::EnableIfOperands<L, R>>
+auto operator+(const L& lhs, const R& rhs)
+{
+    using namespace matrix_expr_detail;
+    return BinaryExpr<ExprOf<L>, ExprOf<R>, Plus>{to_expr(lhs), to_expr(rhs)};
+}
+
+/**
+ * Returns a lazy expression for the entry-wise difference of two matrices or
+ * expressions.
+ */
+template<typename L, typename R, typename = matrix_expr_detail::EnableIfOperands<L, R>>
+auto operator-(const L& lhs, const R& rhs)
+{
+    using namespace matrix_expr_detail;
+    return BinaryExpr<ExprOf<L>, ExprOf<R>, Minus>{to_expr(lhs), to_expr(rhs)};
+}
+
+/**
+ * Returns a lazy expression for a matrix or expression scaled by a scalar.
+ */
+template<typename X, typename S, typename = matrix_expr_detail::EnableIfScalable<X, S>>
+auto operator*(const X& operand, S scalar)
+{
+    using namespace matrix_expr_detail;
+    return ScaleExpr<ExprOf<X>, S>{to_expr(operand), scalar};
+}
+
+template<typename S, typename X, typename = matrix_expr_detail::EnableIfScalable<X, S>>
+auto operator*(S scalar, const X& operand)
+{
+    return operand * scalar;
+}
+
+/**
+ * Returns a lazy expression for the transpose of a matrix expression.
+ */
+template<typename E>
+TransposeExpr<E> transpose(const MatrixExpr<E>& expr)
+{
+    return TransposeExpr<E>{expr.self()};
+}
+
+#endif //ECEE_2160_HOMEWORK_MATRIX_EXPR_H
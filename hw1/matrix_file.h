@@ -0,0 +1,252 @@
+/*
+ * ECEE 2160 Homework assignment 1 binary matrix file declarations.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * File Format
+ * ===========
+ *
+ * A matrix file begins with a 64-byte header, followed immediately by the
+ * matrix entries in row-major order with no padding. All header fields are
+ * written in the byte order recorded by the header itself.
+ *
+ *   Offset  Size  Field
+ *   0       8     Magic bytes "ECEEMAT" followed by a NUL byte
+ *   8       4     Format version (currently 1)
+ *   12      1     Entry type code (see MatrixFileType)
+ *   13      1     Byte order of the writer (1 = little, 2 = big)
+ *   14      2     Reserved, zero
+ *   16      8     Number of rows
+ *   24      8     Number of columns
+ *   32      32    Reserved, zero
+ *
+ * The header occupies a full cache line, so the payload of a file mapped
+ * into memory starts on a cache line boundary.
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_MATRIX_FILE_H
+#define ECEE_2160_HOMEWORK_MATRIX_FILE_H
+
+#include "matrix.h"
+#include "../lab4/posix_api.h"
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint32_t, std::uint64_t
+#include <stdexcept>    // for std::runtime_error, std::invalid_argument
+
+/**
+ * Error class thrown when a matrix file cannot be read or written.
+ */
+class MatrixFileError : public std::runtime_error {
+    // Use base class constructor.
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Entry type codes recorded in matrix file headers.
+ */
+enum class MatrixFileType : std::uint8_t {
+    Int8 = 1,
+    Int16 = 2,
+    Int32 = 3,
+    Int64 = 4,
+    UInt8 = 5,
+    UInt16 = 6,
+    UInt32 = 7,
+    UInt64 = 8,
+    Float32 = 9,
+    Float64 = 10,
+};
+
+/**
+ * Byte order codes recorded in matrix file headers.
+ */
+enum class MatrixFileByteOrder : std::uint8_t {
+    Little = 1,
+    Big = 2,
+};
+
+/**
+ * Header of a matrix file, laid out exactly as stored on disk.
+ */
+struct MatrixFileHeader {
+    /// Magic bytes identifying a matrix file.
+    static constexpr char MAGIC[8] = {'E', 'C', 'E', 'E', 'M', 'A', 'T', '\0'};
+
+    /// Version of the format described above.
+    static constexpr std::uint32_t VERSION{1};
+
+    char magic[8];
+    std::uint32_t version;
+    MatrixFileType type;
+    MatrixFileByteOrder byte_order;
+    std::uint16_t reserved_0;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint8_t reserved_1[32];
+};
+
+static_assert(sizeof(MatrixFileHeader) == 64, "MatrixFileHeader must occupy 64 bytes.");
+
+/**
+ * Returns the byte order of the executing processor.
+ */
+MatrixFileByteOrder native_byte_order();
+
+/**
+ * Returns the header describing a matrix of the given type and dimensions
+ * written by this processor.
+ */
+MatrixFileHeader make_matrix_file_header(
+    MatrixFileType type,
+    std::size_t rows,
+    std::size_t cols
+);
+
+/**
+ * Checks that the given header describes a well-formed matrix file with a
+ * payload of entries of the given type and size in this processor's byte
+ * order.
+ *
+ * @param header Header read from a file.
+ * @param type Expected entry type.
+ * @param file_size Size of the file in bytes, header included.
+ * @throws MatrixFileError if the header is invalid, the entry type or byte
+ *         order do not match, or the file is too short for its payload.
+ */
+void validate_matrix_file_header(
+    const MatrixFileHeader& header,
+    MatrixFileType type,
+    std::size_t file_size
+);
+
+/**
+ * Writes the given matrix to a binary matrix file at the given path,
+ * replacing any existing file.
+ *
+ * @throws MatrixFileError if the file cannot be written.
+ */
+template<typename T>
+void write_matrix_file(const char* path, const Matrix<T>& mat);
+
+/// Default memory budget of transpose_matrix_file(), in bytes.
+constexpr std::size_t DEFAULT_TRANSPOSE_MEMORY{std::size_t{256} << 20u};
+
+/**
+ * Writes the transpose of the matrix file at `src_path` to a new matrix file
+ * at `dst_path`, replacing any existing file, while holding at most
+ * `memory_budget` bytes of entries in memory.
+ *
+ * The matrix is never loaded as a whole, so matrices larger than main memory
+ * may be transposed. The source is read in blocks, one band of rows at a
+ * time. Each block is transposed in memory and written to the matching band
+ * of columns of the destination. Blocks are as close to square as the budget
+ * and matrix dimensions allow, so that both the reads and the writes are made
+ * of long runs of contiguous bytes. When whole source rows fit in a block,
+ * the source is read strictly sequentially.
+ *
+ * The two paths must name different files. Paths that name the same file,
+ * for example through a link, are detected and rejected before anything is
+ * written.
+ *
+ * @param src_path Path to the matrix file to transpose.
+ * @param dst_path Path of the matrix file to write.
+ * @param memory_budget Upper bound on the bytes of buffered entries.
+ * @throws MatrixFileError if either file cannot be opened, read or written,
+ *         if the source does not hold a matrix of type `T`, or if both
+ *         paths name the same file.
+ * @throws std::invalid_argument if the budget cannot hold two entries.
+ */
+template<typename T>
+void transpose_matrix_file(
+    const char* src_path,
+    const char* dst_path,
+    std::size_t memory_budget = DEFAULT_TRANSPOSE_MEMORY
+);
+
+/**
+ * A read-only matrix whose entries are used in place from a memory-mapped
+ * matrix file.
+ *
+ * Opening a view maps the whole file with posix_api::MemoryMapping and checks
+ * its header. The payload is neither parsed nor copied, so pages of the file
+ * are only read from disk once they are accessed. The view exposes the same
+ * read-only interface as Matrix.
+ *
+ * @tparam T Data type of matrix entries, which must match the file.
+ */
+template<typename T>
+class MatrixFileView {
+    /// Mapping of the whole file into this process' address space.
+    posix_api::MemoryMapping m_mapping;
+
+    /// The number of rows in the matrix.
+    std::size_t m_rows{0};
+
+    /// The number of columns per row.
+    std::size_t m_cols{0};
+
+    /// The first entry of the matrix within the mapping.
+    const T* m_values{nullptr};
+
+  public:
+    /// Data type for matrix entries.
+    using Elem = T;
+
+    /// Data type for indexing a matrix via operator[].
+    using Index = std::pair<std::size_t, std::size_t>;
+
+    /// Type for immutable iterators for this matrix.
+    using const_iterator = const Elem*;
+
+    /**
+     * Maps the matrix file at the given path.
+     *
+     * @param path Path to a matrix file.
+     * @throws MatrixFileError if the file cannot be opened or mapped, or if
+     *         it does not hold a matrix of type `T` in this processor's byte
+     *         order.
+     */
+    explicit MatrixFileView(const char* path);
+
+    /*
+     * Moves transfer the mapping. The moved-from view is left empty with
+     * zero rows and columns, like a moved-from Matrix.
+     */
+    MatrixFileView(MatrixFileView&& other) noexcept;
+
+    MatrixFileView& operator=(MatrixFileView&& other) noexcept;
+
+    /**
+     * Returns the number of rows in the matrix.
+     */
+    std::size_t rows() const { return m_rows; }
+
+    /**
+     * Returns the number of columns in the matrix.
+     */
+    std::size_t cols() const { return m_cols; }
+
+    /*
+     * Checked entry access matching Matrix::operator[].
+     */
+    const Elem& operator[](Index elem_index) const;
+
+    /**
+     * Copies the entries of this view into a new, writable matrix.
+     */
+    Matrix<T> to_matrix() const;
+
+    /*
+     * Iterator protocol definitions.
+     */
+    const_iterator begin() const { return m_values; }
+
+    const_iterator end() const { return m_values + (m_rows * m_cols); }
+};
+
+#include "matrix_file.tpp"
+
+#endif //ECEE_2160_HOMEWORK_MATRIX_FILE_H
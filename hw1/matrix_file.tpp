@@ -0,0 +1,355 @@
+/*
+ * ECEE 2160 Homework assignment 1 binary matrix file definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include <algorithm>    // for std::copy, std::min, std::max
+#include <cmath>        // for std::sqrt
+#include <cstring>      // for std::memcpy, std::memcmp
+#include <fstream>      // for std::ofstream
+#include <limits>       // for std::numeric_limits
+#include <utility>      // for std::exchange, std::move
+#include <vector>       // for std::vector
+
+namespace matrix_file_detail {
+
+/**
+ * Maps entry types to their matrix file type codes.
+ *
+ * Only the specializations below are defined, so using a matrix file with
+ * any other entry type fails to compile.
+ */
+template<typename T>
+struct TypeCode;
+
+template<> struct TypeCode<std::int8_t> { static constexpr auto value = MatrixFileType::Int8; };
+template<> struct TypeCode<std::int16_t> { static constexpr auto value = MatrixFileType::Int16; };
+template<> struct TypeCode<std::int32_t> { static constexpr auto value = MatrixFileType::Int32; };
+template<> struct TypeCode<std::int64_t> { static constexpr auto value = MatrixFileType::Int64; };
+template<> struct TypeCode<std::uint8_t> { static constexpr auto value = MatrixFileType::UInt8; };
+template<> struct TypeCode<std::uint16_t> { static constexpr auto value = MatrixFileType::UInt16; };
+template<> struct TypeCode<std::uint32_t> { static constexpr auto value = MatrixFileType::UInt32; };
+template<> struct TypeCode<std::uint64_t> { static constexpr auto value = MatrixFileType::UInt64; };
+template<> struct TypeCode<float> { static constexpr auto value = MatrixFileType::Float32; };
+template<> struct TypeCode<double> { static constexpr auto value = MatrixFileType::Float64; };
+
+} // end namespace matrix_file_detail
+
+inline MatrixFileByteOrder native_byte_order()
+{
+    const std::uint16_t probe{1};
+    std::uint8_t first_byte;
+    std::memcpy(&first_byte, &probe, 1);
+    return first_byte == 1 ? MatrixFileByteOrder::Little : MatrixFileByteOrder::Big;
+}
+
+inline MatrixFileHeader make_matrix_file_header(
+    MatrixFileType type,
+    std::size_t rows,
+    std::size_t cols
+)
+{
+    MatrixFileHeader header{};
+    std::memcpy(header.magic, MatrixFileHeader::MAGIC, sizeof(header.magic));
+    header.version = MatrixFileHeader::VERSION;
+    header.type = type;
+    header.byte_order = native_byte_order();
+    header.rows = rows;
+    header.cols = cols;
+    return header;
+}
+
+inline void validate_matrix_file_header(
+    const MatrixFileHeader& header,
+    MatrixFileType type,
+    std::size_t file_size
+)
+{
+    if (std::memcmp(header.magic, MatrixFileHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw MatrixFileError("not a matrix file");
+    }
+    if (header.byte_order != native_byte_order()) {
+        // Entries are used in place, so they cannot be byte swapped.
+        throw MatrixFileError("matrix file byte order does not match this processor");
+    }
+    if (header.version != MatrixFileHeader::VERSION) {
+        throw MatrixFileError("unsupported matrix file version");
+    }
+    if (header.type != type) {
+        throw MatrixFileError("matrix file entry type does not match");
+    }
+
+    std::size_t entry_size{0};
+    switch (type) {
+        case MatrixFileType::Int8:
+        case MatrixFileType::UInt8:
+            entry_size = 1;
+            break;
+        case MatrixFileType::Int16:
+        case MatrixFileType::UInt16:
+            entry_size = 2;
+            break;
+        case MatrixFileType::Int32:
+        case MatrixFileType::UInt32:
+        case MatrixFileType::Float32:
+            entry_size = 4;
+            break;
+        case MatrixFileType::Int64:
+        case MatrixFileType::UInt64:
+        case MatrixFileType::Float64:
+            entry_size = 8;
+            break;
+    }
+
+    if (file_size < sizeof(MatrixFileHeader)) {
+        throw MatrixFileError("matrix file is truncated");
+    }
+
+    // Compare against the available payload by division so that corrupt
+    // dimensions cannot overflow.
+    const std::size_t payload_capacity{(file_size - sizeof(MatrixFileHeader)) / entry_size};
+    if (header.cols != 0 && header.rows > payload_capacity / header.cols) {
+        throw MatrixFileError("matrix file is truncated");
+    }
+}
+
+template<typename T>
+void write_matrix_file(const char* path, const Matrix<T>& mat)
+{
+    const MatrixFileHeader header{make_matrix_file_header(
+        matrix_file_detail::TypeCode<T>::value, mat.rows(), mat.cols()
+    )};
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(
+        reinterpret_cast<const char*>(mat.begin()),
+        static_cast<std::streamsize>(mat.rows() * mat.cols() * sizeof(T))
+    );
+    out.close();
+
+    if (!out) {
+        throw MatrixFileError("failed to write matrix file");
+    }
+}
+
+template<typename T>
+void transpose_matrix_file(const char* src_path, const char* dst_path, std::size_t memory_budget)
+{
+    // One buffer holds a block of the source, the other its transpose.
+    const std::size_t capacity{memory_budget / (2 * sizeof(T))};
+    if (capacity == 0) {
+        throw std::invalid_argument("memory budget is too small");
+    }
+
+    const posix_api::File src(src_path, posix_api::FileFlag::ReadOnly);
+    if (!src) {
+        throw MatrixFileError("failed to open matrix file");
+    }
+
+    // Truncating the destination below would destroy the source.
+    if (src.is_same_file(dst_path)) {
+        throw MatrixFileError("source and destination are the same matrix file");
+    }
+
+    MatrixFileHeader header;
+    if (!src.read_at(&header, sizeof(header), 0)) {
+        throw MatrixFileError("matrix file is truncated");
+    }
+    validate_matrix_file_header(header, matrix_file_detail::TypeCode<T>::value, src.size());
+
+    const auto rows = static_cast<std::size_t>(header.rows);
+    const auto cols = static_cast<std::size_t>(header.cols);
+
+    // Create the destination with its header in place. The entries are
+    // written below at their final offsets.
+    {
+        const MatrixFileHeader dst_header{make_matrix_file_header(header.type, cols, rows)};
+        std::ofstream out(dst_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&dst_header), sizeof(dst_header));
+        out.close();
+        if (!out) {
+            throw MatrixFileError("failed to write matrix file");
+        }
+    }
+
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+
+    const posix_api::File dst(dst_path, posix_api::FileFlag::ReadWrite);
+    if (!dst) {
+        throw MatrixFileError("failed to open matrix file");
+    }
+
+    // Start from square blocks, then let a short side of the matrix hand its
+    // unused share of the budget to the other side.
+    const auto side = std::max(
+        static_cast<std::size_t>(std::sqrt(static_cast<double>(capacity))),
+        std::size_t{1}
+    );
+    std::size_t block_rows{std::min(rows, side)};
+    const std::size_t block_cols{std::min(cols, capacity / block_rows)};
+    block_rows = std::min(rows, capacity / block_cols);
+
+    const bool whole_rows{block_cols == cols};
+    if (whole_rows) {
+        src.advise(sizeof(MatrixFileHeader), 0, posix_api::FileAdvice::Sequential);
+    }
+
+    std::vector<T> in_block(block_rows * block_cols);
+    std::vector<T> out_block(block_rows * block_cols);
+
+    const auto src_offset = [cols](std::size_t row, std::size_t col) {
+        return sizeof(MatrixFileHeader) + (row * cols + col) * sizeof(T);
+    };
+    const auto dst_offset = [rows](std::size_t row, std::size_t col) {
+        return sizeof(MatrixFileHeader) + (row * rows + col) * sizeof(T);
+    };
+
+    for (std::size_t band_row{0}; band_row < rows; band_row += block_rows) {
+        const std::size_t band_height{std::min(block_rows, rows - band_row)};
+
+        for (std::size_t band_col{0}; band_col < cols; band_col += block_cols) {
+            const std::size_t band_width{std::min(block_cols, cols - band_col)};
+
+            // Read the block, one run per source row unless whole rows are
+            // contiguous in the file.
+            bool read_ok{true};
+            if (whole_rows) {
+                read_ok = src.read_at(
+                    in_block.data(),
+                    band_height * cols * sizeof(T),
+                    src_offset(band_row, 0)
+                );
+            } else {
+                for (std::size_t i_row{0}; read_ok && i_row < band_height; ++i_row) {
+                    read_ok = src.read_at(
+                        in_block.data() + i_row * band_width,
+                        band_width * sizeof(T),
+                        src_offset(band_row + i_row, band_col)
+                    );
+                }
+            }
+            if (!read_ok) {
+                throw MatrixFileError("failed to read matrix file");
+            }
+
+            matrix_detail::recursive_copy_transpose<false>(
+                in_block.data(), band_width, out_block.data(), band_height,
+                0, 0, band_height, band_width
+            );
+
+            // Write the transposed block, one run per destination row unless
+            // the block spans whole destination rows.
+            bool write_ok{true};
+            if (band_height == rows) {
+                write_ok = dst.write_at(
+                    out_block.data(),
+                    band_width * rows * sizeof(T),
+                    dst_offset(band_col, 0)
+                );
+            } else {
+                for (std::size_t i_row{0}; write_ok && i_row < band_width; ++i_row) {
+                    write_ok = dst.write_at(
+                        out_block.data() + i_row * band_height,
+                        band_height * sizeof(T),
+                        dst_offset(band_col + i_row, band_row)
+                    );
+                }
+            }
+            if (!write_ok) {
+                throw MatrixFileError("failed to write matrix file");
+            }
+        }
+
+        // The band of source rows is not read again, so drop it from the
+        // page cache instead of evicting pages that are still needed.
+        src.advise(
+            src_offset(band_row, 0),
+            band_height * cols * sizeof(T),
+            posix_api::FileAdvice::DontNeed
+        );
+    }
+}
+
+template<typename T>
+MatrixFileView<T>::MatrixFileView(const char* path)
+{
+    const posix_api::File file(path, posix_api::FileFlag::ReadOnly);
+    if (!file) {
+        throw MatrixFileError("failed to open matrix file");
+    }
+
+    const std::size_t file_size{file.size()};
+    if (file_size < sizeof(MatrixFileHeader)) {
+        throw MatrixFileError("matrix file is truncated");
+    }
+
+    // The file descriptor may be closed once the mapping exists, see the
+    // documentation of the MemoryMapping constructor.
+    m_mapping = posix_api::MemoryMapping(file, file_size, posix_api::MemoryFlag::Read, 0);
+    if (!m_mapping) {
+        throw MatrixFileError("failed to map matrix file");
+    }
+
+    const auto base = static_cast<const unsigned char*>(m_mapping.data());
+
+    MatrixFileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    validate_matrix_file_header(header, matrix_file_detail::TypeCode<T>::value, file_size);
+
+    m_rows = static_cast<std::size_t>(header.rows);
+    m_cols = static_cast<std::size_t>(header.cols);
+    // The mapping is page aligned and the header fills one cache line, so the
+    // payload is suitably aligned for T.
+    m_values = reinterpret_cast<const T*>(base + sizeof(MatrixFileHeader));
+}
+
+template<typename T>
+MatrixFileView<T>::MatrixFileView(MatrixFileView&& other) noexcept
+    : m_mapping{std::move(other.m_mapping)},
+      m_rows{std::exchange(other.m_rows, 0)},
+      m_cols{std::exchange(other.m_cols, 0)},
+      m_values{std::exchange(other.m_values, nullptr)} {}
+
+template<typename T>
+MatrixFileView<T>& MatrixFileView<T>::operator=(MatrixFileView&& other) noexcept
+{
+    if (this != &other) {
+        // Unmap our file before taking over the other view's mapping, since
+        // move assignment of a MemoryMapping does not release the mapping it
+        // replaces.
+        {
+            const posix_api::MemoryMapping released{std::move(m_mapping)};
+        }
+        m_mapping = std::move(other.m_mapping);
+        m_rows = std::exchange(other.m_rows, 0);
+        m_cols = std::exchange(other.m_cols, 0);
+        m_values = std::exchange(other.m_values, nullptr);
+    }
+    return *this;
+}
+
+template<typename T>
+const typename MatrixFileView<T>::Elem& MatrixFileView<T>::operator[](Index elem_index) const
+{
+    const auto row = elem_index.first;
+    const auto col = elem_index.second;
+
+    if (row >= m_rows || col >= m_cols) {
+        throw std::out_of_range("invalid matrix index");
+    }
+    return m_values[row * m_cols + col];
+}
+
+template<typename T>
+Matrix<T> MatrixFileView<T>::to_matrix() const
+{
+    Matrix<T> mat(m_rows, m_cols);
+    std::copy(begin(), end(), mat.begin());
+    return mat;
+}
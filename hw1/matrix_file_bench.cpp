@@ -0,0 +1,208 @@
+/*
+ * ECEE 2160 Homework assignment 1 out-of-core transpose benchmarks.
+ *
+ * Times transpose_matrix_file() over the same sweep of sizes as hw1-bench,
+ * once with the default memory budget and once with a budget small enough
+ * that all but the smallest matrices are transposed in blocks of partial
+ * rows, and writes the results to standard output as JSON in the layout of
+ * hw1-bench. The matrix files are written to the working directory and
+ * removed afterwards. Files smaller than main memory stay in the page cache
+ * between runs, so for them the results measure the copying and transposing
+ * of the blocks rather than the disk.
+ *
+ * These benchmarks are kept apart from hw1-bench because posix_api.h, which
+ * matrix_file.h includes, declares the POSIX headers inside a namespace and
+ * so cannot share a translation unit with the perf_event headers used for
+ * the hardware counters there.
+ *
+ * Usage: hw1-file-bench [--max-size N] [--warmup N] [--repeats N]
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "matrix.h"
+#include "matrix_file.h"
+
+#include <algorithm>    // for std::sort, std::max
+#include <chrono>       // for std::chrono::steady_clock
+#include <cstdio>       // for std::remove
+#include <cstdlib>      // for std::strtoull
+#include <cstring>      // for std::strcmp
+#include <functional>   // for std::function
+#include <iostream>     // for std::cout, std::cerr
+#include <vector>       // for std::vector
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Smallest matrix size in the sweep.
+constexpr std::size_t MIN_SIZE{8};
+
+/// Default largest matrix size in the sweep.
+constexpr std::size_t DEFAULT_MAX_SIZE{8192};
+
+/// Memory budget of the blocked runs, in bytes.
+constexpr std::size_t SMALL_BUDGET{std::size_t{1} << 20u};
+
+/// Default number of untimed runs before the timed runs.
+constexpr std::size_t DEFAULT_WARMUP{1};
+
+/// Default number of timed runs.
+constexpr std::size_t DEFAULT_REPEATS{5};
+
+/// Number of bytes each timed run should move at least. Small matrices are
+/// transposed repeatedly within a run so that runs are long enough to time.
+constexpr std::size_t MIN_RUN_BYTES{std::size_t{64} << 20u};
+
+/// Paths of the source and destination matrix files.
+constexpr const char SRC_PATH[] = "hw1-file-bench-src.mat";
+constexpr const char DST_PATH[] = "hw1-file-bench-dst.mat";
+
+/**
+ * Summary of the timed runs of one benchmark.
+ */
+struct Measurement {
+    /// Fastest run, in seconds.
+    double min_seconds;
+    /// Median run, in seconds.
+    double median_seconds;
+};
+
+/**
+ * Benchmark settings taken from the command line.
+ */
+struct Options {
+    std::size_t max_size{DEFAULT_MAX_SIZE};
+    std::size_t warmup{DEFAULT_WARMUP};
+    std::size_t repeats{DEFAULT_REPEATS};
+};
+
+/**
+ * Runs the given function `warmup` times untimed, then `repeats` times while
+ * timing each run.
+ */
+Measurement measure(const std::function<void()>& run, const Options& options)
+{
+    for (std::size_t i{0}; i < options.warmup; ++i) {
+        run();
+    }
+
+    std::vector<double> seconds;
+    seconds.reserve(options.repeats);
+    for (std::size_t i{0}; i < options.repeats; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto stop = std::chrono::steady_clock::now();
+        seconds.push_back(std::chrono::duration<double>(stop - start).count());
+    }
+
+    std::sort(seconds.begin(), seconds.end());
+    return Measurement{seconds.front(), seconds[seconds.size() / 2]};
+}
+
+/**
+ * Returns the sizes of the sweep that do not exceed the given size: each
+ * power of two from MIN_SIZE, one more than it, and one and a half times it.
+ */
+std::vector<std::size_t> sweep_sizes(std::size_t max_size)
+{
+    std::vector<std::size_t> sizes;
+    for (std::size_t size{MIN_SIZE}; size <= max_size; size *= 2) {
+        for (const std::size_t candidate : {size, size + 1, size + size / 2}) {
+            if (candidate <= max_size) {
+                sizes.push_back(candidate);
+            }
+        }
+    }
+    return sizes;
+}
+
+/**
+ * Parses the command line into the given options.
+ *
+ * @return `false` if the command line is malformed.
+ */
+bool parse_options(int argc, char* argv[], Options& options)
+{
+    for (int i{1}; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const auto value = static_cast<std::size_t>(std::strtoull(argv[i + 1], nullptr, 10));
+        if (std::strcmp(argv[i], "--max-size") == 0) {
+            options.max_size = value;
+        } else if (std::strcmp(argv[i], "--warmup") == 0) {
+            options.warmup = value;
+        } else if (std::strcmp(argv[i], "--repeats") == 0) {
+            options.repeats = value;
+        } else {
+            return false;
+        }
+    }
+    return options.repeats != 0;
+}
+
+} // end namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--max-size N] [--warmup N] [--repeats N]\n";
+        return 1;
+    }
+
+    auto& out = std::cout;
+    bool first{true};
+
+    out << "{\n"
+        << "  \"warmup\": " << options.warmup << ",\n"
+        << "  \"repeats\": " << options.repeats << ",\n"
+        << "  \"results\": [";
+
+    for (const std::size_t size : sweep_sizes(options.max_size)) {
+        {
+            IntMatrix mat(size, size);
+            int value{0};
+            for (auto& elem : mat) {
+                elem = value++;
+            }
+            write_matrix_file(SRC_PATH, mat);
+        }
+
+        // Every transpose reads and writes each entry once.
+        const auto bytes = static_cast<double>(2 * size * size * sizeof(int));
+        const std::size_t iterations{std::max(
+            MIN_RUN_BYTES / static_cast<std::size_t>(bytes), std::size_t{1}
+        )};
+
+        for (const std::size_t budget : {DEFAULT_TRANSPOSE_MEMORY, SMALL_BUDGET}) {
+            const Measurement m{measure(
+                [&] {
+                    for (std::size_t i{0}; i < iterations; ++i) {
+                        transpose_matrix_file<int>(SRC_PATH, DST_PATH, budget);
+                    }
+                },
+                options
+            )};
+            const auto calls = static_cast<double>(iterations);
+            out << (first ? "\n" : ",\n") << "    {"
+                << "\"benchmark\": \"transpose_matrix_file\", "
+                << "\"size\": " << size << ", "
+                << "\"memory_budget\": " << budget << ", "
+                << "\"iterations\": " << iterations << ", "
+                << "\"threads\": 1, "
+                << "\"seconds_min\": " << m.min_seconds / calls << ", "
+                << "\"seconds_median\": " << m.median_seconds / calls << ", "
+                << "\"gb_per_s\": " << bytes * calls / m.min_seconds / 1e9 << '}';
+            first = false;
+        }
+    }
+
+    std::remove(SRC_PATH);
+    std::remove(DST_PATH);
+
+    out << "\n  ]\n}\n";
+}
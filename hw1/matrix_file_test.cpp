@@ -0,0 +1,287 @@
+/*
+ * ECEE 2160 Homework assignment 1 binary matrix file tests.
+ *
+ * Writes matrices of several entry types and shapes with write_matrix_file(),
+ * maps them back with MatrixFileView and copies them out with to_matrix(),
+ * checking every entry. Moving a view is checked to leave the source view
+ * empty, and files that are missing, truncated, not matrix files, or of the
+ * wrong entry type are checked to be rejected.
+ *
+ * transpose_matrix_file() is checked over the same shapes with memory budgets
+ * from two entries up to the default, so that blocks narrower than one row,
+ * blocks of whole rows and whole matrices are all transposed. Transposing a
+ * file onto itself, directly or through a link, is checked to be refused
+ * without modifying it.
+ *
+ * The test files are created in the working directory and removed
+ * afterwards.
+ *
+ * Failures are written to standard error, and the exit status is nonzero if
+ * any check fails.
+ *
+ * Usage: hw1-matrix-file-test
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "matrix.h"
+#include "matrix_file.h"
+#include "test_checker.h"
+
+#include <algorithm>    // for std::equal
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int8_t, std::uint16_t, std::int64_t
+#include <cstdio>       // for std::remove
+#include <filesystem>   // for std::filesystem::create_hard_link, std::filesystem::create_symlink
+#include <fstream>      // for std::ofstream
+#include <stdexcept>    // for std::out_of_range, std::invalid_argument
+#include <utility>      // for std::move
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Paths of the files written by the test.
+constexpr const char FIRST_PATH[] = "hw1-matrix-file-test-first.mat";
+constexpr const char SECOND_PATH[] = "hw1-matrix-file-test-second.mat";
+constexpr const char HARD_LINK_PATH[] = "hw1-matrix-file-test-hard-link.mat";
+constexpr const char SYMLINK_PATH[] = "hw1-matrix-file-test-symlink.mat";
+
+/// Matrix shapes written, as {rows, cols}.
+constexpr std::size_t SHAPES[][2] = {{0, 0}, {0, 5}, {1, 1}, {3, 5}, {64, 17}, {301, 3}, {300, 301}};
+
+/// Memory budgets of transpose_matrix_file(), in entries. The small budgets
+/// hold less than one row of the wider shapes, so those are read in blocks of
+/// partial rows, while the narrow 301 by 3 shape is read in bands of whole
+/// rows.
+constexpr std::size_t TRANSPOSE_BUDGETS[] = {2, 16, 100, 4096};
+
+/**
+ * Returns a matrix of the given dimensions with distinct entries.
+ */
+template<typename T>
+Matrix<T> make_matrix(std::size_t rows, std::size_t cols)
+{
+    Matrix<T> mat(rows, cols);
+    int value{0};
+    for (auto& elem : mat) {
+        elem = static_cast<T>(value++);
+    }
+    return mat;
+}
+
+/**
+ * Returns `true` if the given matrix or view has the dimensions and entries
+ * of `expected`.
+ */
+template<typename M, typename T>
+bool same_entries(const M& mat, const Matrix<T>& expected)
+{
+    return mat.rows() == expected.rows() && mat.cols() == expected.cols()
+           && std::equal(mat.begin(), mat.end(), expected.begin(), expected.end());
+}
+
+/**
+ * Round-trips matrices of every shape through a matrix file.
+ */
+template<typename T>
+void check_round_trip(Checker& checker, const char* type)
+{
+    for (const auto& shape : SHAPES) {
+        const Matrix<T> original{make_matrix<T>(shape[0], shape[1])};
+        write_matrix_file(FIRST_PATH, original);
+
+        const MatrixFileView<T> view(FIRST_PATH);
+        checker.check(same_entries(view, original), "view", type, "shape", shape[0], shape[1]);
+        checker.check(
+            same_entries(view.to_matrix(), original),
+            "to_matrix", type, "shape", shape[0], shape[1]
+        );
+        if (shape[0] != 0 && shape[1] != 0) {
+            const std::size_t row{shape[0] - 1};
+            const std::size_t col{shape[1] - 1};
+            checker.check(view[{row, col}] == original(row, col), "operator[]", type, "shape", shape[0], shape[1]);
+        }
+        checker.check_throws<std::out_of_range>(
+            [&] { (void) view[{shape[0], 0}]; },
+            "operator[] accepted an out of range row", type
+        );
+    }
+}
+
+/**
+ * Checks that moving a view transfers the mapping and leaves the source
+ * empty.
+ */
+void check_moves(Checker& checker)
+{
+    const Matrix<int> first{make_matrix<int>(4, 6)};
+    const Matrix<int> second{make_matrix<int>(7, 3)};
+    write_matrix_file(FIRST_PATH, first);
+    write_matrix_file(SECOND_PATH, second);
+
+    MatrixFileView<int> source(FIRST_PATH);
+    MatrixFileView<int> moved(std::move(source));
+    checker.check(same_entries(moved, first), "move constructed view");
+    checker.check(
+        source.begin() == nullptr && source.end() == nullptr && source.rows() == 0 && source.cols() == 0,
+        "moved-from view is not empty"
+    );
+    checker.check_throws<std::out_of_range>(
+        [&] { (void) source[{0, 0}]; },
+        "moved-from view accepted an index"
+    );
+    checker.check(source.to_matrix().rows() == 0, "moved-from view copied entries");
+
+    // Assigning over a view that holds a mapping releases that mapping.
+    MatrixFileView<int> assigned(SECOND_PATH);
+    assigned = std::move(moved);
+    checker.check(same_entries(assigned, first), "move assigned view");
+    checker.check(moved.begin() == nullptr && moved.rows() == 0, "moved-from view is not empty after assignment");
+
+    // A moved-from view may be assigned to again.
+    moved = MatrixFileView<int>(SECOND_PATH);
+    checker.check(same_entries(moved, second), "move assigned into a moved-from view");
+}
+
+/**
+ * Checks that files which do not hold a matrix of the requested type are
+ * rejected.
+ */
+void check_rejected_files(Checker& checker)
+{
+    checker.check_throws<MatrixFileError>(
+        [] { MatrixFileView<int> view("hw1-matrix-file-test-missing.mat"); },
+        "opened a missing file"
+    );
+
+    write_matrix_file(FIRST_PATH, make_matrix<int>(3, 3));
+    checker.check_throws<MatrixFileError>(
+        [] { MatrixFileView<float> view(FIRST_PATH); },
+        "opened an int matrix as float"
+    );
+    checker.check_throws<MatrixFileError>(
+        [] { MatrixFileView<unsigned> view(FIRST_PATH); },
+        "opened an int matrix as unsigned"
+    );
+
+    // Drop the last entry.
+    {
+        const MatrixFileHeader header{make_matrix_file_header(MatrixFileType::Int32, 3, 3)};
+        std::ofstream out(SECOND_PATH, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        const Matrix<int> entries{make_matrix<int>(1, 8)};
+        out.write(reinterpret_cast<const char*>(entries.begin()), 8 * sizeof(int));
+    }
+    checker.check_throws<MatrixFileError>(
+        [] { MatrixFileView<int> view(SECOND_PATH); },
+        "opened a truncated file"
+    );
+
+    {
+        std::ofstream out(SECOND_PATH, std::ios::binary | std::ios::trunc);
+        out << "1 2 3\n4 5 6\n";
+    }
+    checker.check_throws<MatrixFileError>(
+        [] { MatrixFileView<int> view(SECOND_PATH); },
+        "opened a short text file"
+    );
+    {
+        std::ofstream out(SECOND_PATH, std::ios::binary | std::ios::trunc);
+        for (int i{0}; i < 20; ++i) {
+            out << "1 2 3\n4 5 6\n";
+        }
+    }
+    checker.check_throws<MatrixFileError>(
+        [] { MatrixFileView<int> view(SECOND_PATH); },
+        "opened a text file"
+    );
+}
+
+/**
+ * Transposes matrices of every shape through matrix files with every memory
+ * budget, and with the default budget, which holds every shape whole.
+ */
+template<typename T>
+void check_file_transpose(Checker& checker, const char* type)
+{
+    for (const auto& shape : SHAPES) {
+        const Matrix<T> original{make_matrix<T>(shape[0], shape[1])};
+        Matrix<T> expected(0, 0);
+        original.transpose_into(expected);
+        write_matrix_file(FIRST_PATH, original);
+
+        for (const std::size_t budget : TRANSPOSE_BUDGETS) {
+            transpose_matrix_file<T>(FIRST_PATH, SECOND_PATH, budget * sizeof(T));
+            checker.check(
+                same_entries(MatrixFileView<T>(SECOND_PATH), expected),
+                "transpose_matrix_file", type, "shape", shape[0], shape[1], "budget", budget
+            );
+        }
+        transpose_matrix_file<T>(FIRST_PATH, SECOND_PATH);
+        checker.check(
+            same_entries(MatrixFileView<T>(SECOND_PATH), expected),
+            "transpose_matrix_file default budget", type, "shape", shape[0], shape[1]
+        );
+    }
+}
+
+/**
+ * Checks that transpose_matrix_file() refuses budgets too small for two
+ * entries and paths that name the same file, leaving the source intact.
+ */
+void check_file_transpose_rejected(Checker& checker)
+{
+    const Matrix<int> original{make_matrix<int>(5, 9)};
+    write_matrix_file(FIRST_PATH, original);
+
+    checker.check_throws<std::invalid_argument>(
+        [] { transpose_matrix_file<int>(FIRST_PATH, SECOND_PATH, 2 * sizeof(int) - 1); },
+        "transpose_matrix_file accepted a budget of less than two entries"
+    );
+
+    std::remove(HARD_LINK_PATH);
+    std::remove(SYMLINK_PATH);
+    std::filesystem::create_hard_link(FIRST_PATH, HARD_LINK_PATH);
+    std::filesystem::create_symlink(FIRST_PATH, SYMLINK_PATH);
+    for (const char* dst_path : {FIRST_PATH, HARD_LINK_PATH, SYMLINK_PATH}) {
+        checker.check_throws<MatrixFileError>(
+            [&] { transpose_matrix_file<int>(FIRST_PATH, dst_path, 64); },
+            "transpose_matrix_file accepted the same file as", dst_path
+        );
+        checker.check(
+            same_entries(MatrixFileView<int>(FIRST_PATH), original),
+            "transpose_matrix_file onto", dst_path, "modified the source"
+        );
+    }
+    std::remove(HARD_LINK_PATH);
+    std::remove(SYMLINK_PATH);
+}
+
+} // end namespace
+
+int main()
+{
+    Checker checker;
+
+    check_round_trip<int>(checker, "int");
+    check_round_trip<std::int8_t>(checker, "int8_t");
+    check_round_trip<std::uint16_t>(checker, "uint16_t");
+    check_round_trip<std::int64_t>(checker, "int64_t");
+    check_round_trip<float>(checker, "float");
+    check_round_trip<double>(checker, "double");
+    check_moves(checker);
+    check_rejected_files(checker);
+
+    check_file_transpose<int>(checker, "int");
+    check_file_transpose<std::int8_t>(checker, "int8_t");
+    check_file_transpose<std::int64_t>(checker, "int64_t");
+    check_file_transpose<double>(checker, "double");
+    check_file_transpose_rejected(checker);
+
+    std::remove(FIRST_PATH);
+    std::remove(SECOND_PATH);
+
+    return checker.report();
+}
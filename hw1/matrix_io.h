@@ -0,0 +1,108 @@
+/*
+ * ECEE 2160 Homework assignment 1 bulk matrix text I/O declarations.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_MATRIX_IO_H
+#define ECEE_2160_HOMEWORK_MATRIX_IO_H
+
+#include "matrix.h"
+
+#include <cstddef>      // for std::size_t
+#include <iosfwd>       // for std::istream, std::ostream (no definitions)
+#include <stdexcept>    // for std::runtime_error
+
+/**
+ * Error class thrown by the bulk matrix readers for malformed input.
+ */
+class MatrixParseError : public std::runtime_error {
+    // Use base class constructor.
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Parses whitespace-delimited entries from the character range [first, last)
+ * into the given matrix in row-major order.
+ *
+ * This is the bulk counterpart of operator>>(std::istream&, Matrix<T>&). Entries
+ * are converted with std::from_chars directly from the buffer, avoiding the
+ * locale and stream state overhead of formatted stream extraction.
+ *
+ * @tparam T Data type of matrix entries.
+ * @param first Start of the text.
+ * @param last End of the text.
+ * @param mat Destination matrix, whose dimensions determine how many entries
+ *            are read.
+ * @return Pointer one past the last character consumed.
+ * @throws MatrixParseError if an entry is malformed or out of range for the
+ *         entry type, or if the text holds too few entries.
+ */
+template<typename T>
+const char* parse_matrix(const char* first, const char* last, Matrix<T>& mat);
+
+/**
+ * Parses whitespace-delimited entries from the character range [first, last)
+ * into the given matrix using multiple threads.
+ *
+ * The text is split into one chunk per thread at line boundaries. Each thread
+ * first counts the entries in its chunk, so that every chunk knows where its
+ * entries begin in the matrix, and then parses its chunk in place. Rows are
+ * therefore not required to occupy exactly one line.
+ *
+ * @tparam T Data type of matrix entries.
+ * @param first Start of the text.
+ * @param last End of the text.
+ * @param mat Destination matrix.
+ * @param thread_count Number of threads, or 0 to use one thread per hardware
+ *                     thread.
+ * @throws MatrixParseError if an entry is malformed or out of range for the
+ *         entry type, or if the text holds a different number of entries
+ *         than the matrix.
+ */
+template<typename T>
+void parallel_parse_matrix(
+    const char* first,
+    const char* last,
+    Matrix<T>& mat,
+    std::size_t thread_count
+);
+
+/**
+ * Reads the remainder of the given stream into a buffer and parses it into
+ * the given matrix.
+ *
+ * The stream must hold exactly as many entries as the matrix, followed by
+ * nothing but whitespace, whichever number of threads parses it.
+ *
+ * @param in Input stream.
+ * @param mat Destination matrix.
+ * @param thread_count Number of parsing threads. One thread parses with
+ *                     parse_matrix(), more use parallel_parse_matrix().
+ * @throws MatrixParseError if an entry is malformed or out of range for the
+ *         entry type, or if the stream holds a different number of entries
+ *         than the matrix.
+ */
+template<typename T>
+void read_matrix(std::istream& in, Matrix<T>& mat, std::size_t thread_count = 1);
+
+/**
+ * Writes the given matrix to the given stream using the same layout as
+ * operator<<(std::ostream&, const Matrix<T>&).
+ *
+ * Entries are formatted with std::to_chars into a large buffer that is
+ * handed to the stream in a single write whenever it fills. Floating point
+ * entries are written in their shortest round-trip form rather than with the
+ * stream's precision.
+ *
+ * @param out Output stream.
+ * @param mat Matrix to be written.
+ */
+template<typename T>
+void write_matrix(std::ostream& out, const Matrix<T>& mat);
+
+#include "matrix_io.tpp"
+
+#endif //ECEE_2160_HOMEWORK_MATRIX_IO_H
@@ -0,0 +1,265 @@
+/*
+ * ECEE 2160 Homework assignment 1 bulk matrix text I/O definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - https://en.cppreference.com/w/cpp/utility/from_chars
+ *  - https://en.cppreference.com/w/cpp/utility/to_chars
+ *
+ */
+
+#include <algorithm>    // for std::find, std::max, std::min
+#include <charconv>     // for std::from_chars, std::to_chars
+#include <cstddef>      // for std::ptrdiff_t
+#include <exception>    // for std::exception_ptr
+#include <istream>      // for std::istream
+#include <ostream>      // for std::ostream
+#include <system_error> // for std::errc
+#include <thread>       // for std::thread
+#include <utility>      // for std::pair
+#include <vector>       // for std::vector
+
+namespace matrix_io_detail {
+
+/// Size of the formatting buffer used by write_matrix().
+constexpr std::size_t WRITE_BUFFER_SIZE{std::size_t{1} << 16u};
+
+/// Size of the chunks read from a stream by read_matrix().
+constexpr std::size_t READ_CHUNK_SIZE{std::size_t{1} << 20u};
+
+/// Upper bound on the characters needed to format one entry.
+constexpr std::size_t MAX_ENTRY_CHARS{64};
+
+/**
+ * Returns `true` if the given character is whitespace in the "C" locale.
+ */
+inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * Returns a pointer to the first non-whitespace character in [first, last).
+ */
+inline const char* skip_space(const char* first, const char* last)
+{
+    while (first != last && is_space(*first)) {
+        ++first;
+    }
+    return first;
+}
+
+/**
+ * Parses one entry starting at `first`, which must not be whitespace.
+ *
+ * A leading '+' is accepted to match stream extraction, although
+ * std::from_chars rejects it.
+ *
+ * @return Pointer one past the entry.
+ * @throws MatrixParseError if the entry is malformed or out of range.
+ */
+template<typename T>
+const char* parse_entry(const char* first, const char* last, T& value)
+{
+    if (*first == '+' && last - first > 1 && *(first + 1) != '-') {
+        ++first;
+    }
+    const auto result = std::from_chars(first, last, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        throw MatrixParseError("matrix entry out of range");
+    }
+    if (result.ec != std::errc{} || (result.ptr != last && !is_space(*result.ptr))) {
+        throw MatrixParseError("malformed matrix entry");
+    }
+    return result.ptr;
+}
+
+/**
+ * Parses up to `count` entries from [first, last) into `dst`.
+ *
+ * @return Pair of the pointer one past the last consumed character and the
+ *         number of entries parsed.
+ */
+template<typename T>
+std::pair<const char*, std::size_t> parse_entries(
+    const char* first,
+    const char* last,
+    T* dst,
+    std::size_t count
+)
+{
+    std::size_t parsed{0};
+    while (parsed < count) {
+        first = skip_space(first, last);
+        if (first == last) {
+            break;
+        }
+        first = parse_entry(first, last, dst[parsed]);
+        ++parsed;
+    }
+    return {first, parsed};
+}
+
+/**
+ * Returns the number of whitespace-delimited tokens in [first, last).
+ */
+inline std::size_t count_tokens(const char* first, const char* last)
+{
+    std::size_t tokens{0};
+    bool in_token{false};
+    for (; first != last; ++first) {
+        const bool space{is_space(*first)};
+        tokens += static_cast<std::size_t>(in_token && space);
+        in_token = !space;
+    }
+    return tokens + static_cast<std::size_t>(in_token);
+}
+
+} // end namespace matrix_io_detail
+
+template<typename T>
+const char* parse_matrix(const char* first, const char* last, Matrix<T>& mat)
+{
+    const std::size_t size{mat.rows() * mat.cols()};
+    const auto result = matrix_io_detail::parse_entries(first, last, mat.begin(), size);
+    if (result.second != size) {
+        throw MatrixParseError("too few matrix entries");
+    }
+    return result.first;
+}
+
+template<typename T>
+void parallel_parse_matrix(
+    const char* first,
+    const char* last,
+    Matrix<T>& mat,
+    std::size_t thread_count
+)
+{
+    if (thread_count == 0) {
+        // hardware_concurrency() may return 0 if the count is unknown.
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // Split the text into chunks of roughly equal length, moving each chunk
+    // boundary forward to the start of the next line so that no entry is
+    // divided between chunks.
+    const auto length = static_cast<std::size_t>(last - first);
+    std::vector<const char*> bounds{first};
+    for (std::size_t i{1}; i < thread_count; ++i) {
+        const char* bound{std::max(first + length * i / thread_count, bounds.back())};
+        bound = std::find(bound, last, '\n');
+        bounds.push_back(bound == last ? last : bound + 1);
+    }
+    bounds.push_back(last);
+
+    const std::size_t chunk_count{bounds.size() - 1};
+
+    // Runs the given function once per chunk, using one thread per chunk.
+    const auto for_each_chunk = [chunk_count](auto&& func) {
+        std::vector<std::thread> workers;
+        workers.reserve(chunk_count - 1);
+        for (std::size_t i{1}; i < chunk_count; ++i) {
+            workers.emplace_back(func, i);
+        }
+        func(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    };
+
+    // Count the entries in each chunk, and locate the first matrix entry
+    // belonging to each chunk.
+    std::vector<std::size_t> offsets(chunk_count + 1);
+    for_each_chunk([&](std::size_t i) {
+        offsets[i + 1] = matrix_io_detail::count_tokens(bounds[i], bounds[i + 1]);
+    });
+    for (std::size_t i{0}; i < chunk_count; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    if (offsets.back() != mat.rows() * mat.cols()) {
+        throw MatrixParseError("matrix entry count does not match matrix dimensions");
+    }
+
+    // Parse each chunk in place. Exceptions cannot cross thread boundaries,
+    // so the first parsing error from each chunk is saved and rethrown.
+    std::vector<std::exception_ptr> errors(chunk_count);
+    for_each_chunk([&](std::size_t i) {
+        try {
+            matrix_io_detail::parse_entries(
+                bounds[i], bounds[i + 1], mat.begin() + offsets[i], offsets[i + 1] - offsets[i]
+            );
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    });
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+template<typename T>
+void read_matrix(std::istream& in, Matrix<T>& mat, std::size_t thread_count)
+{
+    // Read the rest of the stream in large unformatted chunks.
+    std::vector<char> buffer;
+    std::size_t used{0};
+    do {
+        buffer.resize(used + matrix_io_detail::READ_CHUNK_SIZE);
+        in.read(buffer.data() + used, static_cast<std::streamsize>(matrix_io_detail::READ_CHUNK_SIZE));
+        used += static_cast<std::size_t>(in.gcount());
+    } while (in);
+
+    const char* const first{buffer.data()};
+    if (thread_count == 1) {
+        // Reject anything but whitespace after the last entry, as the
+        // parallel parser does when it counts the entries.
+        const char* const rest{parse_matrix(first, first + used, mat)};
+        if (matrix_io_detail::skip_space(rest, first + used) != first + used) {
+            throw MatrixParseError("matrix entry count does not match matrix dimensions");
+        }
+    } else {
+        parallel_parse_matrix(first, first + used, mat, thread_count);
+    }
+}
+
+template<typename T>
+void write_matrix(std::ostream& out, const Matrix<T>& mat)
+{
+    using namespace matrix_io_detail;
+
+    constexpr std::size_t delim_length{sizeof(matrix_detail::DELIM) - 1};
+
+    std::vector<char> buffer(WRITE_BUFFER_SIZE);
+    char* const buffer_end{buffer.data() + buffer.size()};
+    char* pos{buffer.data()};
+
+    std::size_t col_counter{0};
+    for (const auto elem : mat) {
+        // Flush the buffer once it might not hold another entry.
+        if (buffer_end - pos < static_cast<std::ptrdiff_t>(MAX_ENTRY_CHARS + delim_length)) {
+            out.write(buffer.data(), pos - buffer.data());
+            pos = buffer.data();
+        }
+
+        // Formatting cannot fail since the buffer has room for any entry.
+        pos = std::to_chars(pos, buffer_end, elem).ptr;
+
+        // Cycle column counter
+        col_counter = (col_counter + 1) % mat.cols();
+        // If this is the last column of a row, print a newline.
+        if (col_counter == 0) {
+            *pos++ = '\n';
+        } else {
+            pos = std::copy_n(matrix_detail::DELIM, delim_length, pos);
+        }
+    }
+
+    out.write(buffer.data(), pos - buffer.data());
+}
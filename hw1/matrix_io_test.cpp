@@ -0,0 +1,202 @@
+/*
+ * ECEE 2160 Homework assignment 1 bulk matrix text I/O tests.
+ *
+ * Round-trips matrices of several entry types and shapes through
+ * write_matrix() and read_matrix() with one and several parsing threads, and
+ * checks that malformed entries, entries out of range for the entry type, and
+ * too few or too many entries are rejected by every parser. Failures are
+ * written to standard error, and the exit status is nonzero if any check
+ * fails.
+ *
+ * Usage: hw1-matrix-io-test
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "matrix.h"
+#include "matrix_io.h"
+#include "test_checker.h"
+
+#include <algorithm>    // for std::equal
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int8_t, std::uint8_t, std::uint16_t, std::int64_t
+#include <cstring>      // for std::strlen
+#include <limits>       // for std::numeric_limits
+#include <sstream>      // for std::istringstream, std::ostringstream
+#include <string>       // for std::string
+#include <type_traits>  // for std::is_integral
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Thread counts passed to read_matrix(). Counts above one parse with
+/// parallel_parse_matrix(), including counts above the number of lines.
+constexpr std::size_t THREAD_COUNTS[] = {1, 2, 3, 8, 64};
+
+/// Matrix shapes round-tripped, as {rows, cols}. The last shape spans
+/// several write and read buffers.
+constexpr std::size_t SHAPES[][2] = {{1, 1}, {1, 7}, {7, 1}, {3, 5}, {40, 33}, {600, 500}};
+
+/**
+ * Returns a matrix of the given dimensions whose entries include negative
+ * values where T is signed and the extremes of T's range.
+ */
+template<typename T>
+Matrix<T> make_matrix(std::size_t rows, std::size_t cols)
+{
+    Matrix<T> mat(rows, cols);
+    long long value{-3};
+    for (auto& elem : mat) {
+        elem = static_cast<T>(value);
+        value = value * 7 + 5;
+        if (value > 1000000 || value < -1000000) {
+            value %= 1000;
+        }
+    }
+    mat(0, 0) = std::numeric_limits<T>::lowest();
+    mat(rows - 1, cols - 1) = std::numeric_limits<T>::max();
+    return mat;
+}
+
+/**
+ * Returns `true` if the two matrices have the same dimensions and entries.
+ */
+template<typename T>
+bool equal_matrices(const Matrix<T>& a, const Matrix<T>& b)
+{
+    return a.rows() == b.rows() && a.cols() == b.cols() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+/**
+ * Writes matrices of every shape with write_matrix() and reads them back
+ * with read_matrix() with every thread count.
+ */
+template<typename T>
+void check_round_trip(Checker& checker, const char* type)
+{
+    for (const auto& shape : SHAPES) {
+        const Matrix<T> original{make_matrix<T>(shape[0], shape[1])};
+        std::ostringstream out;
+        write_matrix(out, original);
+        const std::string text{out.str()};
+
+        // The bulk writer uses the layout of operator<<.
+        std::ostringstream stream_out;
+        stream_out << original;
+        if constexpr (std::is_integral<T>::value) {
+            checker.check(text == stream_out.str(), "write_matrix layout", type, "shape", shape[0], shape[1]);
+        }
+
+        for (const std::size_t threads : THREAD_COUNTS) {
+            Matrix<T> read(shape[0], shape[1]);
+            std::istringstream in{text};
+            read_matrix(in, read, threads);
+            checker.check(
+                equal_matrices(read, original),
+                "round trip", type, "shape", shape[0], shape[1], "threads", threads
+            );
+        }
+
+        const char* const first{text.data()};
+        Matrix<T> parsed(shape[0], shape[1]);
+        const char* const rest{parse_matrix(first, first + text.size(), parsed)};
+        checker.check(
+            equal_matrices(parsed, original) && rest == first + text.size() - 1,
+            "parse_matrix", type, "shape", shape[0], shape[1]
+        );
+    }
+}
+
+/**
+ * Reads the given text into a matrix of the given dimensions with every
+ * thread count, checking that the entries equal `expected`.
+ */
+template<typename T>
+void check_read(
+    Checker& checker,
+    const char* text,
+    std::size_t rows,
+    std::size_t cols,
+    const T* expected
+)
+{
+    for (const std::size_t threads : THREAD_COUNTS) {
+        Matrix<T> mat(rows, cols);
+        std::istringstream in{text};
+        read_matrix(in, mat, threads);
+        checker.check(
+            std::equal(mat.begin(), mat.end(), expected),
+            "read", '"' + std::string(text) + '"', "threads", threads
+        );
+    }
+}
+
+/**
+ * Checks that reading the given text into a matrix of the given dimensions
+ * raises MatrixParseError with every thread count.
+ */
+template<typename T>
+void check_rejected(Checker& checker, const char* text, std::size_t rows, std::size_t cols)
+{
+    for (const std::size_t threads : THREAD_COUNTS) {
+        Matrix<T> mat(rows, cols);
+        std::istringstream in{text};
+        checker.check_throws<MatrixParseError>(
+            [&] { read_matrix(in, mat, threads); },
+            "accepted", '"' + std::string(text) + '"', "threads", threads
+        );
+    }
+}
+
+} // end namespace
+
+int main()
+{
+    Checker checker;
+
+    check_round_trip<int>(checker, "int");
+    check_round_trip<std::int8_t>(checker, "int8_t");
+    check_round_trip<std::uint16_t>(checker, "uint16_t");
+    check_round_trip<std::int64_t>(checker, "int64_t");
+    check_round_trip<float>(checker, "float");
+    check_round_trip<double>(checker, "double");
+
+    // Rows need not occupy one line each, and a leading '+' is accepted as
+    // by stream extraction.
+    const int values[] = {1, -2, 3, 4, 5, 6};
+    check_read(checker, "1 -2\n3\n\n4 5\r\n+6\n\n", 2, 3, values);
+    check_read(checker, "  \t1 -2 3 4 5 6", 3, 2, values);
+    const std::int8_t extremes[] = {-128, 127};
+    check_read(checker, "-128 127", 1, 2, extremes);
+
+    // Malformed entries.
+    check_rejected<int>(checker, "1 2 x 4", 2, 2);
+    check_rejected<int>(checker, "1 2 3.5 4", 2, 2);
+    check_rejected<int>(checker, "1 2 3 4-", 2, 2);
+    check_rejected<int>(checker, "1 2 + 4", 2, 2);
+    check_rejected<int>(checker, "1\n2\n3\n+-4\n", 2, 2);
+    check_rejected<double>(checker, "1.0 nan? 3 4", 2, 2);
+
+    // Entries out of range for the entry type.
+    check_rejected<std::int8_t>(checker, "1 2\n3 128\n", 2, 2);
+    check_rejected<std::int8_t>(checker, "-129 2\n3 4\n", 2, 2);
+    check_rejected<std::uint8_t>(checker, "1 2\n-1 4\n", 2, 2);
+    check_rejected<int>(checker, "1 2 3 99999999999999999999", 2, 2);
+
+    // Too few and too many entries.
+    check_rejected<int>(checker, "", 1, 1);
+    check_rejected<int>(checker, "1 2 3", 2, 2);
+    check_rejected<int>(checker, "1 2\n3 4\n5\n", 2, 2);
+    check_rejected<int>(checker, "1 2 3 4 5", 2, 2);
+
+    // parse_matrix() stops after the last entry of the matrix and leaves the
+    // rest of the text to the caller.
+    const char text[] = "1 2 3 4 tail";
+    Matrix<int> mat(2, 2);
+    const char* const rest{parse_matrix(text, text + std::strlen(text), mat)};
+    checker.check(rest == text + 7 && mat(1, 1) == 4, "parse_matrix with trailing text");
+
+    return checker.report();
+}
@@ -0,0 +1,487 @@
+/*
+ * ECEE 2160 Homework assignment 1 matrix reduction definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - https://gcc.gnu.org/onlinedocs/gcc/Common-Function-Attributes.html
+ *
+ */
+
+#include "matrix_reduce.h"
+
+#include <algorithm>    // for std::min, std::max
+#include <cstdint>      // for std::int8_t, ..., std::uint64_t
+#include <cstring>      // for std::memcpy
+#include <stdexcept>    // for std::invalid_argument, std::logic_error
+#include <thread>       // for std::thread
+#include <type_traits>  // for std::conditional_t, std::is_same
+#include <utility>      // for std::move
+#include <vector>       // for std::vector
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/**
+ * Number of independent partial results kept by each kernel.
+ *
+ * The kernels process runs of LANES entries with loops of constant trip
+ * count, which the compiler fully vectorizes. Sixteen 64-bit partial sums
+ * fill four AVX2 registers.
+ */
+constexpr std::size_t LANES{16};
+
+/// Type in which sums of the given entry type are computed.
+template<typename T>
+using Acc = MatrixWrappingAccumulator<T>;
+
+/// Unsigned integer type holding the bit pattern of the given entry type.
+template<typename T>
+using Bits = std::conditional_t<sizeof(T) <= sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+
+/**
+ * Returns the bit pattern of the given entry, zero extended to 64 bits.
+ */
+template<typename T>
+__attribute__((always_inline))
+inline std::uint64_t entry_bits(T value)
+{
+    // Narrow types are copied into the low bytes of a zeroed word, which
+    // matches zero extension on little endian processors. Big endian
+    // processors give a different, but equally valid, checksum.
+    Bits<T> bits{0};
+    std::memcpy(&bits, &value, sizeof(value));
+    return static_cast<std::uint64_t>(bits);
+}
+
+/**
+ * Returns the sum of the given run of entries.
+ */
+template<typename T>
+__attribute__((always_inline))
+inline Acc<T> sum_body(const T* values, std::size_t count)
+{
+    Acc<T> lanes[LANES]{};
+    std::size_t i{0};
+    for (; i + LANES <= count; i += LANES) {
+        for (std::size_t j{0}; j < LANES; ++j) {
+            lanes[j] += static_cast<Acc<T>>(values[i + j]);
+        }
+    }
+
+    Acc<T> total{0};
+    for (; i < count; ++i) {
+        total += static_cast<Acc<T>>(values[i]);
+    }
+    for (std::size_t j{0}; j < LANES; ++j) {
+        total += lanes[j];
+    }
+    return total;
+}
+
+/**
+ * Adds the given run of entries to the running sums at the same positions.
+ */
+template<typename T>
+__attribute__((always_inline))
+inline void add_body(const T* values, std::size_t count, Acc<T>* sums)
+{
+    std::size_t i{0};
+    for (; i + LANES <= count; i += LANES) {
+        // All loads happen before all stores, so the compiler may vectorize
+        // the run without proving that `sums` and `values` do not overlap.
+        Acc<T> run[LANES];
+        for (std::size_t j{0}; j < LANES; ++j) {
+            run[j] = sums[i + j] + static_cast<Acc<T>>(values[i + j]);
+        }
+        for (std::size_t j{0}; j < LANES; ++j) {
+            sums[i + j] = run[j];
+        }
+    }
+    for (; i < count; ++i) {
+        sums[i] += static_cast<Acc<T>>(values[i]);
+    }
+}
+
+/**
+ * Widens the given range of the running extrema to include the given
+ * nonempty run of entries.
+ */
+template<typename T>
+__attribute__((always_inline))
+inline void min_max_body(const T* values, std::size_t count, T& low, T& high)
+{
+    T lows[LANES];
+    T highs[LANES];
+    for (std::size_t j{0}; j < LANES; ++j) {
+        lows[j] = low;
+        highs[j] = high;
+    }
+
+    std::size_t i{0};
+    for (; i + LANES <= count; i += LANES) {
+        for (std::size_t j{0}; j < LANES; ++j) {
+            const T value{values[i + j]};
+            lows[j] = value < lows[j] ? value : lows[j];
+            highs[j] = highs[j] < value ? value : highs[j];
+        }
+    }
+    for (; i < count; ++i) {
+        low = std::min(low, values[i]);
+        high = std::max(high, values[i]);
+    }
+    for (std::size_t j{0}; j < LANES; ++j) {
+        low = std::min(low, lows[j]);
+        high = std::max(high, highs[j]);
+    }
+}
+
+/**
+ * Returns the weighted sum of the bit patterns of the given run of entries,
+ * where `first` is the row-major position of the first entry of the run.
+ */
+template<typename T>
+__attribute__((always_inline))
+inline std::uint64_t checksum_body(const T* values, std::size_t count, std::uint64_t first)
+{
+    std::uint64_t lanes[LANES]{};
+    std::size_t i{0};
+    for (; i + LANES <= count; i += LANES) {
+        const std::uint64_t base{2 * (first + i) + 1};
+        for (std::size_t j{0}; j < LANES; ++j) {
+            lanes[j] += entry_bits(values[i + j]) * (base + 2 * j);
+        }
+    }
+
+    std::uint64_t total{0};
+    for (; i < count; ++i) {
+        total += entry_bits(values[i]) * (2 * (first + i) + 1);
+    }
+    for (std::size_t j{0}; j < LANES; ++j) {
+        total += lanes[j];
+    }
+    return total;
+}
+
+/**
+ * A family of reduction kernels compiled for one instruction set.
+ */
+template<typename T>
+struct ReduceKernels {
+    Acc<T> (*sum)(const T* values, std::size_t count);
+    void (*add)(const T* values, std::size_t count, Acc<T>* sums);
+    void (*min_max)(const T* values, std::size_t count, T& low, T& high);
+    std::uint64_t (*checksum)(const T* values, std::size_t count, std::uint64_t first);
+};
+
+/// Kernels compiled for the baseline instruction set.
+template<typename T>
+struct GenericKernels {
+    static Acc<T> sum(const T* values, std::size_t count)
+    {
+        return sum_body(values, count);
+    }
+
+    static void add(const T* values, std::size_t count, Acc<T>* sums)
+    {
+        add_body(values, count, sums);
+    }
+
+    static void min_max(const T* values, std::size_t count, T& low, T& high)
+    {
+        min_max_body(values, count, low, high);
+    }
+
+    static std::uint64_t checksum(const T* values, std::size_t count, std::uint64_t first)
+    {
+        return checksum_body(values, count, first);
+    }
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+/// Kernels compiled for AVX2, which provides 8-wide 32-bit minimum and
+/// maximum, and sign extension of 32-bit entries to 64-bit sums (vpmovsxdq).
+template<typename T>
+struct Avx2Kernels {
+    __attribute__((target("avx2")))
+    static Acc<T> sum(const T* values, std::size_t count)
+    {
+        return sum_body(values, count);
+    }
+
+    __attribute__((target("avx2")))
+    static void add(const T* values, std::size_t count, Acc<T>* sums)
+    {
+        add_body(values, count, sums);
+    }
+
+    __attribute__((target("avx2")))
+    static void min_max(const T* values, std::size_t count, T& low, T& high)
+    {
+        min_max_body(values, count, low, high);
+    }
+
+    __attribute__((target("avx2")))
+    static std::uint64_t checksum(const T* values, std::size_t count, std::uint64_t first)
+    {
+        return checksum_body(values, count, first);
+    }
+};
+#endif
+
+/**
+ * Returns the fastest reduction kernels supported by the processor. The
+ * processor is only queried on the first call.
+ */
+template<typename T>
+const ReduceKernels<T>& select_kernels()
+{
+    static const ReduceKernels<T> kernels = []() -> ReduceKernels<T> {
+#if defined(__x86_64__) || defined(__i386__)
+        if (__builtin_cpu_supports("avx2")) {
+            using K = Avx2Kernels<T>;
+            return {&K::sum, &K::add, &K::min_max, &K::checksum};
+        }
+#endif
+        using K = GenericKernels<T>;
+        return {&K::sum, &K::add, &K::min_max, &K::checksum};
+    }();
+    return kernels;
+}
+
+/**
+ * Converts the given sums to the result type of the reductions.
+ */
+template<typename T>
+std::vector<MatrixAccumulator<T>> to_results(std::vector<Acc<T>>&& sums)
+{
+    if constexpr (std::is_same<Acc<T>, MatrixAccumulator<T>>::value) {
+        return std::move(sums);
+    } else {
+        std::vector<MatrixAccumulator<T>> results(sums.size());
+        for (std::size_t i{0}; i < sums.size(); ++i) {
+            results[i] = static_cast<MatrixAccumulator<T>>(sums[i]);
+        }
+        return results;
+    }
+}
+
+/**
+ * Returns the number of workers that process the given number of rows.
+ *
+ * @param thread_count Number of threads, or 0 to use one thread per
+ *                     hardware thread. Never more threads than rows are used.
+ */
+std::size_t worker_count(std::size_t rows, std::size_t thread_count)
+{
+    if (thread_count == 0) {
+        // hardware_concurrency() may return 0 if the count is unknown.
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return std::min(thread_count, std::max(rows, std::size_t{1}));
+}
+
+/**
+ * Calls `work(worker, first_row, last_row)` for equally sized contiguous
+ * ranges of the given number of rows, one range per worker.
+ */
+template<typename F>
+void for_each_row_range(std::size_t rows, std::size_t workers_used, const F& work)
+{
+    const auto range_start = [=](std::size_t worker) {
+        return rows * worker / workers_used;
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(workers_used - 1);
+    for (std::size_t i{1}; i < workers_used; ++i) {
+        workers.emplace_back(work, i, range_start(i), range_start(i + 1));
+    }
+
+    // The calling thread processes the first range.
+    work(std::size_t{0}, range_start(0), range_start(1));
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // end namespace
+
+template<typename T>
+MatrixAccumulator<T> sum(const Matrix<T>& mat, std::size_t thread_count)
+{
+    const auto& kernels = select_kernels<T>();
+    const std::size_t cols{mat.cols()};
+
+    // Consecutive rows are contiguous, so each range is summed as one run.
+    const std::size_t used{worker_count(mat.rows(), thread_count)};
+    std::vector<Acc<T>> partials(used);
+    for_each_row_range(
+        mat.rows(), used,
+        [&](std::size_t worker, std::size_t first, std::size_t last) {
+            partials[worker] = kernels.sum(mat.begin() + first * cols, (last - first) * cols);
+        }
+    );
+
+    Acc<T> total{0};
+    for (const auto partial : partials) {
+        total += partial;
+    }
+    return static_cast<MatrixAccumulator<T>>(total);
+}
+
+template<typename T>
+std::vector<MatrixAccumulator<T>> row_sums(const Matrix<T>& mat, std::size_t thread_count)
+{
+    const auto& kernels = select_kernels<T>();
+    const std::size_t cols{mat.cols()};
+
+    std::vector<Acc<T>> sums(mat.rows());
+    for_each_row_range(
+        mat.rows(), worker_count(mat.rows(), thread_count),
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            for (std::size_t i_row{first}; i_row < last; ++i_row) {
+                sums[i_row] = kernels.sum(mat.begin() + i_row * cols, cols);
+            }
+        }
+    );
+    return to_results<T>(std::move(sums));
+}
+
+template<typename T>
+std::vector<MatrixAccumulator<T>> col_sums(const Matrix<T>& mat, std::size_t thread_count)
+{
+    const auto& kernels = select_kernels<T>();
+    const std::size_t cols{mat.cols()};
+
+    // The first worker adds its rows directly to the result. Other workers
+    // use private running sums, which are added to the result afterwards.
+    const std::size_t used{worker_count(mat.rows(), thread_count)};
+    std::vector<Acc<T>> sums(cols);
+    std::vector<std::vector<Acc<T>>> partials(used);
+    for_each_row_range(
+        mat.rows(), used,
+        [&](std::size_t worker, std::size_t first, std::size_t last) {
+            Acc<T>* running{sums.data()};
+            if (worker != 0) {
+                partials[worker].assign(cols, Acc<T>{0});
+                running = partials[worker].data();
+            }
+            for (std::size_t i_row{first}; i_row < last; ++i_row) {
+                kernels.add(mat.begin() + i_row * cols, cols, running);
+            }
+        }
+    );
+
+    for (std::size_t worker{1}; worker < used; ++worker) {
+        for (std::size_t i_col{0}; i_col < cols; ++i_col) {
+            sums[i_col] += partials[worker][i_col];
+        }
+    }
+    return to_results<T>(std::move(sums));
+}
+
+template<typename T>
+std::pair<T, T> min_max(const Matrix<T>& mat, std::size_t thread_count)
+{
+    if (mat.begin() == mat.end()) {
+        throw std::invalid_argument("matrix has no entries");
+    }
+
+    const auto& kernels = select_kernels<T>();
+    const std::size_t cols{mat.cols()};
+
+    // Every range starts from the first entry, which is in the result anyway.
+    const T first_entry{*mat.begin()};
+    const std::size_t used{worker_count(mat.rows(), thread_count)};
+    std::vector<std::pair<T, T>> partials(used, {first_entry, first_entry});
+    for_each_row_range(
+        mat.rows(), used,
+        [&](std::size_t worker, std::size_t first, std::size_t last) {
+            auto& extrema = partials[worker];
+            kernels.min_max(
+                mat.begin() + first * cols, (last - first) * cols, extrema.first, extrema.second
+            );
+        }
+    );
+
+    std::pair<T, T> result{partials[0]};
+    for (std::size_t i{1}; i < used; ++i) {
+        result.first = std::min(result.first, partials[i].first);
+        result.second = std::max(result.second, partials[i].second);
+    }
+    return result;
+}
+
+template<typename T>
+MatrixAccumulator<T> trace(const Matrix<T>& mat)
+{
+    if (mat.rows() != mat.cols()) {
+        throw std::logic_error("matrix must be square");
+    }
+
+    // The diagonal touches one entry per row, so there is nothing to
+    // vectorize or divide between threads.
+    Acc<T> total{0};
+    for (std::size_t i{0}; i < mat.rows(); ++i) {
+        total += static_cast<Acc<T>>(mat(i, i));
+    }
+    return static_cast<MatrixAccumulator<T>>(total);
+}
+
+template<typename T>
+std::uint64_t checksum(const Matrix<T>& mat, std::size_t thread_count)
+{
+    const auto& kernels = select_kernels<T>();
+    const std::size_t cols{mat.cols()};
+
+    const std::size_t used{worker_count(mat.rows(), thread_count)};
+    std::vector<std::uint64_t> partials(used);
+    for_each_row_range(
+        mat.rows(), used,
+        [&](std::size_t worker, std::size_t first, std::size_t last) {
+            partials[worker] = kernels.checksum(
+                mat.begin() + first * cols, (last - first) * cols, first * cols
+            );
+        }
+    );
+
+    std::uint64_t total{0};
+    for (const auto partial : partials) {
+        total += partial;
+    }
+
+    // Mix in the dimensions so that reshaping the entries changes the result.
+    // The multipliers are odd constants from the golden ratio hash.
+    constexpr std::uint64_t ROW_MULTIPLIER{0x9E3779B97F4A7C15u};
+    constexpr std::uint64_t COL_MULTIPLIER{0xC2B2AE3D27D4EB4Fu};
+    return total ^ (mat.rows() * ROW_MULTIPLIER) ^ (mat.cols() * COL_MULTIPLIER);
+}
+
+/*
+ * Explicit instantiations for the supported entry types.
+ */
+#define ECEE_2160_INSTANTIATE_REDUCTIONS(T) \
+    template MatrixAccumulator<T> sum(const Matrix<T>&, std::size_t); \
+    template std::vector<MatrixAccumulator<T>> row_sums(const Matrix<T>&, std::size_t); \
+    template std::vector<MatrixAccumulator<T>> col_sums(const Matrix<T>&, std::size_t); \
+    template std::pair<T, T> min_max(const Matrix<T>&, std::size_t); \
+    template MatrixAccumulator<T> trace(const Matrix<T>&); \
+    template std::uint64_t checksum(const Matrix<T>&, std::size_t);
+
+ECEE_2160_INSTANTIATE_REDUCTIONS(std::int8_t)
+ECEE_2160_INSTANTIATE_REDUCTIONS(std::int16_t)
+ECEE_2160_INSTANTIATE_REDUCTIONS(std::int32_t)
+ECEE_2160_INSTANTIATE_REDUCTIONS(std::int64_t)
+ECEE_2160_INSTANTIATE_REDUCTIONS(std::uint8_t)
+ECEE_2160_INSTANTIATE_REDUCTIONS(std::uint16_t)
+ECEE_2160_INSTANTIATE_REDUCTIONS(std::uint32_t)
+ECEE_2160_INSTANTIATE_REDUCTIONS(std::uint64_t)
+ECEE_2160_INSTANTIATE_REDUCTIONS(float)
+ECEE_2160_INSTANTIATE_REDUCTIONS(double)
+
+#undef ECEE_2160_INSTANTIATE_REDUCTIONS
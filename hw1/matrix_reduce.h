@@ -0,0 +1,88 @@
+/*
+ * ECEE 2160 Homework assignment 1 matrix reduction declarations.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_MATRIX_REDUCE_H
+#define ECEE_2160_HOMEWORK_MATRIX_REDUCE_H
+
+#include "matrix.h"
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <utility>      // for std::pair
+#include <vector>       // for std::vector
+
+/*
+ * Reductions over the entries of a matrix.
+ *
+ * Entries are summed in MatrixAccumulator<T>, so sums of entries of up to 32
+ * bits never overflow. Sums of 64-bit integers wrap modulo 2^64, and sums of
+ * signed 64-bit integers are returned as signed values. The kernels keep several independent partial results
+ * per row so that the compiler can vectorize them. On x86 processors
+ * supporting AVX2, kernels compiled for AVX2 are selected at runtime.
+ *
+ * Functions taking a thread count split the rows of the matrix into equally
+ * sized contiguous ranges, one per thread, with the calling thread processing
+ * one of the ranges. A thread count of 0 uses one thread per hardware thread.
+ *
+ * These functions are explicitly instantiated in matrix_reduce.cpp for
+ * signed and unsigned integers of 8, 16, 32 and 64 bits, `float` and
+ * `double`.
+ */
+
+/**
+ * Returns the sum of all entries of the given matrix.
+ */
+template<typename T>
+MatrixAccumulator<T> sum(const Matrix<T>& mat, std::size_t thread_count = 1);
+
+/**
+ * Returns the sum of each row of the given matrix.
+ */
+template<typename T>
+std::vector<MatrixAccumulator<T>> row_sums(const Matrix<T>& mat, std::size_t thread_count = 1);
+
+/**
+ * Returns the sum of each column of the given matrix.
+ *
+ * Columns are not walked one at a time. Instead, every row is added to a
+ * vector of running column sums, so the matrix is read in a single row-major
+ * sweep. Each thread keeps its own running sums, which are added together
+ * at the end.
+ */
+template<typename T>
+std::vector<MatrixAccumulator<T>> col_sums(const Matrix<T>& mat, std::size_t thread_count = 1);
+
+/**
+ * Returns the smallest and largest entries of the given matrix.
+ *
+ * This function raises std::invalid_argument if the matrix has no entries.
+ */
+template<typename T>
+std::pair<T, T> min_max(const Matrix<T>& mat, std::size_t thread_count = 1);
+
+/**
+ * Returns the sum of the diagonal entries of the given matrix.
+ *
+ * This function raises std::logic_error if the matrix is not square.
+ */
+template<typename T>
+MatrixAccumulator<T> trace(const Matrix<T>& mat);
+
+/**
+ * Returns a checksum of the dimensions and entries of the given matrix.
+ *
+ * The checksum is the sum, modulo 2^64, of the bit pattern of each entry
+ * multiplied by the odd weight 2i + 1, where i is the position of the entry
+ * in row-major order, mixed with the dimensions of the matrix. Changing any
+ * single entry always changes the checksum, and reordering entries almost
+ * always does. It is meant to detect accidental changes, not tampering.
+ */
+template<typename T>
+std::uint64_t checksum(const Matrix<T>& mat, std::size_t thread_count = 1);
+
+#endif //ECEE_2160_HOMEWORK_MATRIX_REDUCE_H
@@ -0,0 +1,222 @@
+/*
+ * ECEE 2160 Homework assignment 1 matrix reduction tests.
+ *
+ * Checks sum(), row_sums(), col_sums(), min_max(), trace() and checksum()
+ * against plain scalar loops for signed and unsigned integers of 8, 16, 32
+ * and 64 bits, `float` and `double`. Signed entries include negative values
+ * and the extremes of the entry type, so that sums of 64-bit entries wrap.
+ * Row lengths are not multiples of the kernel lane count, and thread counts
+ * range up to more threads than rows. The reductions are called through
+ * their public interface, so they run the AVX2 kernels on processors that
+ * support AVX2 and the baseline kernels elsewhere.
+ *
+ * Failures are written to standard error, and the exit status is nonzero if
+ * any check fails.
+ *
+ * Usage: hw1-matrix-reduce-test
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "matrix.h"
+#include "matrix_reduce.h"
+#include "test_checker.h"
+
+#include <algorithm>    // for std::min, std::max
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int8_t, ..., std::uint64_t
+#include <cstring>      // for std::memcpy
+#include <iostream>     // for std::cout
+#include <limits>       // for std::numeric_limits
+#include <type_traits>  // for std::is_same, std::is_integral, std::conditional_t
+#include <utility>      // for std::pair, std::declval
+#include <vector>       // for std::vector
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Matrix shapes tested, as {rows, cols}.
+constexpr std::size_t SHAPES[][2] = {{1, 1}, {1, 17}, {17, 1}, {5, 5}, {3, 33}, {64, 64}, {100, 131}};
+
+/// Thread counts tested, including counts above the number of rows.
+constexpr std::size_t THREAD_COUNTS[] = {0, 1, 2, 3, 8, 200};
+
+// Sums of signed entries are returned as signed values.
+static_assert(std::is_same<MatrixAccumulator<std::int8_t>, std::int64_t>::value, "");
+static_assert(std::is_same<MatrixAccumulator<std::int64_t>, std::int64_t>::value, "");
+static_assert(std::is_same<MatrixAccumulator<std::uint64_t>, std::uint64_t>::value, "");
+static_assert(std::is_same<MatrixWrappingAccumulator<std::int64_t>, std::uint64_t>::value, "");
+static_assert(std::is_same<decltype(sum(std::declval<const Matrix<std::int64_t>&>())), std::int64_t>::value, "");
+
+/**
+ * Returns a matrix of the given dimensions whose entries include negative
+ * values where T is signed, and the extremes of T's range where T is an
+ * integer. Floating point entries are small integers, so that their sums are
+ * exact in any order.
+ */
+template<typename T>
+Matrix<T> make_matrix(std::size_t rows, std::size_t cols)
+{
+    Matrix<T> mat(rows, cols);
+    unsigned state{7};
+    for (auto& elem : mat) {
+        // A linear congruential generator is random enough here.
+        state = state * 1103515245u + 12345u;
+        const int value{static_cast<int>((state >> 16u) % 201u) - 100};
+        elem = static_cast<T>(value);
+    }
+    if (std::is_integral<T>::value) {
+        mat(0, 0) = std::numeric_limits<T>::lowest();
+        mat(rows - 1, cols - 1) = std::numeric_limits<T>::max();
+        mat(rows / 2, cols / 2) = std::numeric_limits<T>::max();
+    }
+    return mat;
+}
+
+/**
+ * Returns a matrix of the given dimensions whose entries are all -1, or the
+ * largest value of T where T is unsigned.
+ */
+template<typename T>
+Matrix<T> make_negative_matrix(std::size_t rows, std::size_t cols)
+{
+    Matrix<T> mat(rows, cols);
+    for (auto& elem : mat) {
+        elem = static_cast<T>(-1);
+    }
+    return mat;
+}
+
+/**
+ * Returns the sum of the entries of `mat` selected by `select(row, col)`,
+ * computed one entry at a time.
+ */
+template<typename T, typename F>
+MatrixAccumulator<T> scalar_sum(const Matrix<T>& mat, const F& select)
+{
+    MatrixWrappingAccumulator<T> total{0};
+    for (std::size_t row{0}; row < mat.rows(); ++row) {
+        for (std::size_t col{0}; col < mat.cols(); ++col) {
+            if (select(row, col)) {
+                total += static_cast<MatrixWrappingAccumulator<T>>(mat(row, col));
+            }
+        }
+    }
+    return static_cast<MatrixAccumulator<T>>(total);
+}
+
+/**
+ * Returns the checksum of the given matrix as documented for checksum(),
+ * computed one entry at a time.
+ */
+template<typename T>
+std::uint64_t scalar_checksum(const Matrix<T>& mat)
+{
+    using Bits = std::conditional_t<sizeof(T) <= sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+    std::uint64_t total{0};
+    std::uint64_t position{0};
+    for (const T elem : mat) {
+        Bits bits{0};
+        std::memcpy(&bits, &elem, sizeof(elem));
+        total += static_cast<std::uint64_t>(bits) * (2 * position++ + 1);
+    }
+    return total ^ (mat.rows() * std::uint64_t{0x9E3779B97F4A7C15u})
+           ^ (mat.cols() * std::uint64_t{0xC2B2AE3D27D4EB4Fu});
+}
+
+/**
+ * Checks every reduction of the given matrix against the scalar loops.
+ */
+template<typename T>
+void check_matrix(Checker& checker, const Matrix<T>& mat, const char* type, const char* kind)
+{
+    const std::size_t rows{mat.rows()};
+    const std::size_t cols{mat.cols()};
+
+    const auto expected_sum = scalar_sum(mat, [](std::size_t, std::size_t) { return true; });
+    std::vector<MatrixAccumulator<T>> expected_rows(rows);
+    for (std::size_t i{0}; i < rows; ++i) {
+        expected_rows[i] = scalar_sum(mat, [i](std::size_t row, std::size_t) { return row == i; });
+    }
+    std::vector<MatrixAccumulator<T>> expected_cols(cols);
+    for (std::size_t i{0}; i < cols; ++i) {
+        expected_cols[i] = scalar_sum(mat, [i](std::size_t, std::size_t col) { return col == i; });
+    }
+    std::pair<T, T> expected_extrema{mat(0, 0), mat(0, 0)};
+    for (const T elem : mat) {
+        expected_extrema.first = std::min(expected_extrema.first, elem);
+        expected_extrema.second = std::max(expected_extrema.second, elem);
+    }
+    const std::uint64_t expected_checksum{scalar_checksum(mat)};
+
+    for (const std::size_t threads : THREAD_COUNTS) {
+        checker.check(sum(mat, threads) == expected_sum, "sum", type, kind, "shape", rows, cols, "threads", threads);
+        checker.check(
+            row_sums(mat, threads) == expected_rows,
+            "row_sums", type, kind, "shape", rows, cols, "threads", threads
+        );
+        checker.check(
+            col_sums(mat, threads) == expected_cols,
+            "col_sums", type, kind, "shape", rows, cols, "threads", threads
+        );
+        checker.check(
+            min_max(mat, threads) == expected_extrema,
+            "min_max", type, kind, "shape", rows, cols, "threads", threads
+        );
+        checker.check(
+            checksum(mat, threads) == expected_checksum,
+            "checksum", type, kind, "shape", rows, cols, "threads", threads
+        );
+    }
+
+    if (rows == cols) {
+        const auto expected_trace = scalar_sum(mat, [](std::size_t row, std::size_t col) { return row == col; });
+        checker.check(trace(mat) == expected_trace, "trace", type, kind, "shape", rows, cols);
+    }
+}
+
+/**
+ * Checks the reductions of matrices of every shape for one entry type.
+ */
+template<typename T>
+void check_reductions(Checker& checker, const char* type)
+{
+    for (const auto& shape : SHAPES) {
+        check_matrix(checker, make_matrix<T>(shape[0], shape[1]), type, "mixed");
+        check_matrix(checker, make_negative_matrix<T>(shape[0], shape[1]), type, "negative");
+    }
+
+    // Sums of negative signed entries are negative, whatever the entry size.
+    if constexpr (std::numeric_limits<T>::is_signed) {
+        const Matrix<T> negative{make_negative_matrix<T>(10, 30)};
+        checker.check(sum(negative) == -300, "sum of negative entries", type);
+        checker.check(row_sums(negative)[9] == -30 && col_sums(negative)[29] == -10, "row and column sums of negative entries", type);
+        checker.check(trace(make_negative_matrix<T>(7, 7)) == -7, "trace of negative entries", type);
+    }
+}
+
+} // end namespace
+
+int main()
+{
+    Checker checker;
+
+#if defined(__x86_64__) || defined(__i386__)
+    std::cout << (__builtin_cpu_supports("avx2") ? "testing the AVX2 kernels\n" : "testing the baseline kernels\n");
+#endif
+
+    check_reductions<std::int8_t>(checker, "int8_t");
+    check_reductions<std::int16_t>(checker, "int16_t");
+    check_reductions<std::int32_t>(checker, "int32_t");
+    check_reductions<std::int64_t>(checker, "int64_t");
+    check_reductions<std::uint8_t>(checker, "uint8_t");
+    check_reductions<std::uint16_t>(checker, "uint16_t");
+    check_reductions<std::uint32_t>(checker, "uint32_t");
+    check_reductions<std::uint64_t>(checker, "uint64_t");
+    check_reductions<float>(checker, "float");
+    check_reductions<double>(checker, "double");
+
+    return checker.report();
+}
@@ -0,0 +1,265 @@
+/*
+ * ECEE 2160 Homework assignment 1 strided matrix views.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - https://en.cppreference.com/w/cpp/container/mdspan
+ *  - https://numpy.org/doc/stable/reference/arrays.ndarray.html#internal-memory-layout-of-an-ndarray
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_MATRIX_VIEW_H
+#define ECEE_2160_HOMEWORK_MATRIX_VIEW_H
+
+#include "matrix.h"
+
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t, std::ptrdiff_t
+#include <stdexcept>    // for std::out_of_range, std::invalid_argument
+#include <type_traits>  // for std::remove_const_t, std::is_same, std::is_const
+#include <utility>      // for std::pair, std::swap
+
+/**
+ * A non-owning view of matrix entries addressed through row and column
+ * strides.
+ *
+ * Entry (row, col) of a view lives at `data + row * row_stride + col *
+ * col_stride`. A view of a whole Matrix has a row stride equal to its column
+ * count and a column stride of one. Sub-blocks, single rows and single
+ * columns of a view only change the base pointer and extents, and the
+ * transpose of a view only exchanges its extents and strides, so none of
+ * these operations move any entries.
+ *
+ * Views are matrix expressions, so they may be combined with other
+ * expressions and assigned to a Matrix, or copied with copy().
+ *
+ * A view must not outlive the entries it refers to.
+ *
+ * @tparam T Data type of matrix entries. Use `const T` for read-only views.
+ */
+template<typename T>
+class MatrixView : public MatrixExpr<MatrixView<T>> {
+    /// Location of entry (0, 0).
+    T* m_data;
+
+    /// The number of rows in the view.
+    std::size_t m_rows;
+
+    /// The number of columns in the view.
+    std::size_t m_cols;
+
+    /// Distance between vertically adjacent entries, in entries.
+    std::ptrdiff_t m_row_stride;
+
+    /// Distance between horizontally adjacent entries, in entries.
+    std::ptrdiff_t m_col_stride;
+
+  public:
+    /// Data type for matrix entries.
+    using value_type = std::remove_const_t<T>;
+
+    /// Data type for indexing a matrix via operator[].
+    using Index = std::pair<std::size_t, std::size_t>;
+
+    /// Entries are addressed through strides, so they cannot be addressed by
+    /// a single row-major index.
+    static constexpr bool is_linear{false};
+
+    /// Width of the square tiles copy() uses when the source and destination
+    /// are contiguous along different dimensions.
+    static constexpr std::size_t COPY_TILE_SIZE{64};
+
+    /**
+     * Constructs a view from raw entry storage.
+     *
+     * @param data Location of entry (0, 0).
+     * @param rows The number of rows.
+     * @param cols The number of columns.
+     * @param row_stride Distance between vertically adjacent entries.
+     * @param col_stride Distance between horizontally adjacent entries.
+     */
+    MatrixView(
+        T* data,
+        std::size_t rows,
+        std::size_t cols,
+        std::ptrdiff_t row_stride,
+        std::ptrdiff_t col_stride
+    ) : m_data{data}, m_rows{rows}, m_cols{cols}, m_row_stride{row_stride}, m_col_stride{col_stride} {}
+
+    /**
+     * Constructs a view of every entry of the given matrix.
+     */
+    MatrixView(Matrix<value_type>& mat)
+        : MatrixView(mat.begin(), mat.rows(), mat.cols(), static_cast<std::ptrdiff_t>(mat.cols()), 1) {}
+
+    /**
+     * Constructs a read-only view of every entry of the given matrix.
+     */
+    template<typename U = T, typename = std::enable_if_t<std::is_const<U>::value>>
+    MatrixView(const Matrix<value_type>& mat)
+        : MatrixView(mat.begin(), mat.rows(), mat.cols(), static_cast<std::ptrdiff_t>(mat.cols()), 1) {}
+
+    /**
+     * Converts a mutable view to a read-only view.
+     */
+    template<typename U = T, typename = std::enable_if_t<std::is_const<U>::value>>
+    MatrixView(const MatrixView<value_type>& other)
+        : MatrixView(other.data(), other.rows(), other.cols(), other.row_stride(), other.col_stride()) {}
+
+    std::size_t rows() const { return m_rows; }
+
+    std::size_t cols() const { return m_cols; }
+
+    std::ptrdiff_t row_stride() const { return m_row_stride; }
+
+    std::ptrdiff_t col_stride() const { return m_col_stride; }
+
+    T* data() const { return m_data; }
+
+    /**
+     * Returns `true` if each row of this view is stored contiguously.
+     */
+    bool has_contiguous_rows() const { return m_col_stride == 1; }
+
+    /**
+     * Returns `true` if each column of this view is stored contiguously.
+     */
+    bool has_contiguous_cols() const { return m_row_stride == 1; }
+
+    /*
+     * Unchecked entry access.
+     */
+    T& operator()(std::size_t row, std::size_t col) const
+    {
+        return m_data[static_cast<std::ptrdiff_t>(row) * m_row_stride
+                      + static_cast<std::ptrdiff_t>(col) * m_col_stride];
+    }
+
+    /*
+     * Checked entry access matching Matrix::operator[].
+     */
+    T& operator[](Index elem_index) const
+    {
+        if (elem_index.first >= m_rows || elem_index.second >= m_cols) {
+            throw std::out_of_range("invalid matrix index");
+        }
+        return (*this)(elem_index.first, elem_index.second);
+    }
+
+    /**
+     * Returns a view of the block of this view with the given top-left corner
+     * and extents.
+     *
+     * @throws std::out_of_range if the block does not fit within this view.
+     */
+    MatrixView block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) const
+    {
+        if (row > m_rows || col > m_cols || rows > m_rows - row || cols > m_cols - col) {
+            throw std::out_of_range("invalid matrix block");
+        }
+        return MatrixView(rows == 0 || cols == 0 ? m_data : &(*this)(row, col), rows, cols, m_row_stride, m_col_stride);
+    }
+
+    /**
+     * Returns a 1 by cols() view of the given row.
+     */
+    MatrixView row(std::size_t row) const { return block(row, 0, 1, m_cols); }
+
+    /**
+     * Returns a rows() by 1 view of the given column.
+     */
+    MatrixView col(std::size_t col) const { return block(0, col, m_rows, 1); }
+
+    /**
+     * Returns a view of the transpose of this view. No entries are moved.
+     */
+    MatrixView t() const { return MatrixView(m_data, m_cols, m_rows, m_col_stride, m_row_stride); }
+
+    /**
+     * Returns `true` if any entry of this view may lie in the byte range
+     * [first, last). Required by MatrixExpr.
+     */
+    bool aliases(const void* first, const void* last) const
+    {
+        if (m_rows == 0 || m_cols == 0) {
+            return false;
+        }
+        // Locate the lowest and highest addressed entries of the view.
+        const std::ptrdiff_t row_span{static_cast<std::ptrdiff_t>(m_rows - 1) * m_row_stride};
+        const std::ptrdiff_t col_span{static_cast<std::ptrdiff_t>(m_cols - 1) * m_col_stride};
+        const std::ptrdiff_t low{std::min<std::ptrdiff_t>(row_span, 0) + std::min<std::ptrdiff_t>(col_span, 0)};
+        const std::ptrdiff_t high{std::max<std::ptrdiff_t>(row_span, 0) + std::max<std::ptrdiff_t>(col_span, 0)};
+        return matrix_expr_detail::overlaps(m_data + low, m_data + high + 1, first, last);
+    }
+};
+
+/**
+ * Copies the entries of one view into another view of equal dimensions.
+ *
+ * The loop order follows the strides of the views. When the destination
+ * rows (or columns) are contiguous and the source rows (or columns) are too,
+ * entries are copied along that dimension. When the two views are contiguous
+ * along different dimensions, as when copying a transposed view into a
+ * matrix, the entries are copied in square tiles so that both views are
+ * accessed a cache line at a time.
+ *
+ * The source may be a read-only or a mutable view of the destination's entry
+ * type.
+ *
+ * @throws std::invalid_argument if the dimensions of the views differ.
+ */
+template<typename S, typename T>
+void copy(const MatrixView<S>& src, const MatrixView<T>& dst)
+{
+    static_assert(
+        std::is_same<std::remove_const_t<S>, T>::value,
+        "copy() requires a mutable destination with the entry type of the source."
+    );
+
+    if (src.rows() != dst.rows() || src.cols() != dst.cols()) {
+        throw std::invalid_argument("matrix dimensions do not agree");
+    }
+
+    // Express both views so that the destination is walked along its
+    // contiguous dimension, if it has one, in the inner loop.
+    MatrixView<const T> from{src};
+    MatrixView<T> to{dst};
+    if (!to.has_contiguous_rows() && to.has_contiguous_cols()) {
+        from = from.t();
+        to = to.t();
+    }
+
+    const std::size_t rows{to.rows()};
+    const std::size_t cols{to.cols()};
+
+    if (from.has_contiguous_rows() || !from.has_contiguous_cols()) {
+        // The inner loop walks both views along rows.
+        for (std::size_t i_row{0}; i_row < rows; ++i_row) {
+            for (std::size_t i_col{0}; i_col < cols; ++i_col) {
+                to(i_row, i_col) = from(i_row, i_col);
+            }
+        }
+        return;
+    }
+
+    // The source is contiguous down its columns while the destination is
+    // contiguous along its rows.
+    constexpr std::size_t tile{MatrixView<T>::COPY_TILE_SIZE};
+    for (std::size_t tile_row{0}; tile_row < rows; tile_row += tile) {
+        const std::size_t row_end{std::min(tile_row + tile, rows)};
+        for (std::size_t tile_col{0}; tile_col < cols; tile_col += tile) {
+            const std::size_t col_end{std::min(tile_col + tile, cols)};
+            for (std::size_t i_row{tile_row}; i_row < row_end; ++i_row) {
+                for (std::size_t i_col{tile_col}; i_col < col_end; ++i_col) {
+                    to(i_row, i_col) = from(i_row, i_col);
+                }
+            }
+        }
+    }
+}
+
+#endif //ECEE_2160_HOMEWORK_MATRIX_VIEW_H
@@ -0,0 +1,232 @@
+/*
+ * ECEE 2160 Homework assignment 1 strided matrix view tests.
+ *
+ * Checks the entries addressed by views of whole matrices, blocks, rows,
+ * columns and transposes, and checks copy() between views contiguous along
+ * the same and along different dimensions, over shapes that are not
+ * multiples of the copy tile width. The source of a copy is given both as a
+ * read-only and as a mutable view. Views are also checked as matrix
+ * expressions assigned to a matrix, including a transposed view of the
+ * matrix being assigned.
+ *
+ * Failures are written to standard error, and the exit status is nonzero if
+ * any check fails.
+ *
+ * Usage: hw1-matrix-view-test
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "matrix.h"
+#include "matrix_view.h"
+#include "test_checker.h"
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int64_t
+#include <stdexcept>    // for std::out_of_range, std::invalid_argument
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Matrix shapes tested, as {rows, cols}. Includes sides just below, at and
+/// just past the copy tile width.
+constexpr std::size_t SHAPES[][2] = {
+    {1, 1}, {1, 9}, {9, 1}, {3, 5}, {63, 64}, {64, 65}, {65, 130}, {200, 129},
+};
+
+/**
+ * Returns a matrix of the given dimensions with distinct entries.
+ */
+template<typename T>
+Matrix<T> make_matrix(std::size_t rows, std::size_t cols)
+{
+    Matrix<T> mat(rows, cols);
+    int value{0};
+    for (auto& elem : mat) {
+        elem = static_cast<T>(value++);
+    }
+    return mat;
+}
+
+/**
+ * Returns `true` if entry (row, col) of the view is entry (row + row_offset,
+ * col + col_offset) of `mat`, or of its transpose if `transposed` is set.
+ */
+template<typename V, typename T>
+bool views_entries(
+    const V& view,
+    const Matrix<T>& mat,
+    std::size_t row_offset,
+    std::size_t col_offset,
+    bool transposed
+)
+{
+    for (std::size_t row{0}; row < view.rows(); ++row) {
+        for (std::size_t col{0}; col < view.cols(); ++col) {
+            const std::size_t mat_row{(transposed ? col : row) + row_offset};
+            const std::size_t mat_col{(transposed ? row : col) + col_offset};
+            if (view(row, col) != mat(mat_row, mat_col)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns `true` if `result` is the transpose of `original`.
+ */
+template<typename T>
+bool is_transpose(const Matrix<T>& result, const Matrix<T>& original)
+{
+    return result.rows() == original.cols() && result.cols() == original.rows()
+           && views_entries(MatrixView<const T>(result), original, 0, 0, true);
+}
+
+/**
+ * Checks the entries addressed by views derived from a view of a whole
+ * matrix.
+ */
+template<typename T>
+void check_views(Checker& checker, const char* type)
+{
+    for (const auto& shape : SHAPES) {
+        const std::size_t rows{shape[0]};
+        const std::size_t cols{shape[1]};
+        Matrix<T> mat{make_matrix<T>(rows, cols)};
+        const MatrixView<T> whole(mat);
+
+        checker.check(
+            whole.rows() == rows && whole.cols() == cols && views_entries(whole, mat, 0, 0, false),
+            "whole view", type, "shape", rows, cols
+        );
+        checker.check(
+            whole.t().rows() == cols && views_entries(whole.t(), mat, 0, 0, true),
+            "transposed view", type, "shape", rows, cols
+        );
+        checker.check(
+            views_entries(whole.block(rows / 2, cols / 3, rows - rows / 2, cols / 2), mat, rows / 2, cols / 3, false),
+            "block", type, "shape", rows, cols
+        );
+        checker.check(
+            views_entries(whole.t().block(cols / 3, rows / 2, cols / 2, rows - rows / 2), mat, rows / 2, cols / 3, true),
+            "block of transposed view", type, "shape", rows, cols
+        );
+        checker.check(views_entries(whole.row(rows - 1), mat, rows - 1, 0, false), "row", type, "shape", rows, cols);
+        checker.check(views_entries(whole.col(cols - 1), mat, 0, cols - 1, false), "col", type, "shape", rows, cols);
+
+        // Writes through a view land in the matrix.
+        whole.t()(cols - 1, 0) = static_cast<T>(-1);
+        checker.check(mat(0, cols - 1) == static_cast<T>(-1), "write through view", type, "shape", rows, cols);
+
+        checker.check_throws<std::out_of_range>(
+            [&] { (void) whole[{rows, 0}]; },
+            "operator[] accepted an out of range row", type
+        );
+        checker.check_throws<std::out_of_range>(
+            [&] { (void) whole.block(1, 0, rows, cols); },
+            "block accepted a block past the view", type
+        );
+    }
+}
+
+/**
+ * Checks copy() between views contiguous along every pair of dimensions.
+ */
+template<typename T>
+void check_copy(Checker& checker, const char* type)
+{
+    for (const auto& shape : SHAPES) {
+        const std::size_t rows{shape[0]};
+        const std::size_t cols{shape[1]};
+        Matrix<T> original{make_matrix<T>(rows, cols)};
+        const Matrix<T> original_t{original.t()};
+
+        // Rows to rows, from a read-only and from a mutable source.
+        Matrix<T> same(rows, cols);
+        copy(MatrixView<const T>(original), MatrixView<T>(same));
+        checker.check(views_entries(MatrixView<const T>(same), original, 0, 0, false), "copy", type, "shape", rows, cols);
+        Matrix<T> from_mutable(rows, cols);
+        copy(MatrixView<T>(original), MatrixView<T>(from_mutable));
+        checker.check(
+            views_entries(MatrixView<const T>(from_mutable), original, 0, 0, false),
+            "copy from mutable view", type, "shape", rows, cols
+        );
+
+        // Columns to rows, which is copied tile by tile.
+        Matrix<T> transposed(cols, rows);
+        copy(MatrixView<const T>(original).t(), MatrixView<T>(transposed));
+        checker.check(is_transpose(transposed, original), "copy of transposed view", type, "shape", rows, cols);
+
+        // Rows to columns.
+        Matrix<T> into_t(cols, rows);
+        copy(MatrixView<T>(original), MatrixView<T>(into_t).t());
+        checker.check(is_transpose(into_t, original), "copy into transposed view", type, "shape", rows, cols);
+
+        // Columns to columns.
+        Matrix<T> both_t(cols, rows);
+        copy(MatrixView<const T>(original_t).t(), MatrixView<T>(both_t).t());
+        checker.check(is_transpose(both_t, original), "copy between transposed views", type, "shape", rows, cols);
+
+        // Neither dimension contiguous: every other column of a wider matrix.
+        Matrix<T> wide(rows, 2 * cols);
+        const MatrixView<T> strided(wide.begin(), rows, cols, static_cast<std::ptrdiff_t>(2 * cols), 2);
+        copy(MatrixView<const T>(original).t(), strided.t());
+        checker.check(views_entries(strided, original, 0, 0, false), "copy into strided view", type, "shape", rows, cols);
+
+        checker.check_throws<std::invalid_argument>(
+            [&] { copy(MatrixView<const T>(original), MatrixView<T>(wide)); },
+            "copy accepted views of different dimensions", type
+        );
+    }
+}
+
+/**
+ * Checks views used as matrix expressions.
+ */
+template<typename T>
+void check_expressions(Checker& checker, const char* type)
+{
+    for (const auto& shape : SHAPES) {
+        const std::size_t rows{shape[0]};
+        const std::size_t cols{shape[1]};
+        const Matrix<T> original{make_matrix<T>(rows, cols)};
+
+        const Matrix<T> from_view{MatrixView<const T>(original).t()};
+        checker.check(is_transpose(from_view, original), "matrix from transposed view", type, "shape", rows, cols);
+
+        const Matrix<T> sum{MatrixView<const T>(original) + MatrixView<const T>(original)};
+        bool sum_ok{true};
+        for (std::size_t row{0}; row < rows; ++row) {
+            for (std::size_t col{0}; col < cols; ++col) {
+                sum_ok = sum_ok && sum(row, col) == static_cast<T>(original(row, col) + original(row, col));
+            }
+        }
+        checker.check(sum_ok, "sum of views", type, "shape", rows, cols);
+
+        // The assigned matrix is read through the view, so the view must be
+        // detected as aliasing it.
+        Matrix<T> aliased{make_matrix<T>(rows, cols)};
+        aliased = MatrixView<const T>(aliased).t();
+        checker.check(is_transpose(aliased, original), "assignment of aliasing view", type, "shape", rows, cols);
+    }
+}
+
+} // end namespace
+
+int main()
+{
+    Checker checker;
+
+    check_views<int>(checker, "int");
+    check_views<double>(checker, "double");
+    check_copy<int>(checker, "int");
+    check_copy<float>(checker, "float");
+    check_copy<std::int64_t>(checker, "int64_t");
+    check_expressions<int>(checker, "int");
+    check_expressions<double>(checker, "double");
+
+    return checker.report();
+}
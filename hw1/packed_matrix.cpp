@@ -0,0 +1,573 @@
+/*
+ * ECEE 2160 Homework assignment 1 packed integer matrix definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "packed_matrix.h"
+
+#include <algorithm>    // for std::min, std::max, std::fill
+#include <array>        // for std::array
+#include <cstring>      // for std::memcpy, std::memcmp
+#include <fstream>      // for std::ifstream, std::ofstream
+#include <limits>       // for std::numeric_limits
+#include <stdexcept>    // for std::out_of_range, std::invalid_argument, std::logic_error
+#include <type_traits>  // for std::conditional_t
+#include <utility>      // for std::index_sequence, std::make_pair
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+constexpr std::size_t TILE{PackedIntMatrix::TILE};
+
+constexpr std::size_t TILE_ENTRIES{PackedIntMatrix::TILE_ENTRIES};
+
+/// Largest bits per entry of a tile.
+constexpr std::size_t MAX_WIDTH{32};
+
+/// Bytes of padding after the payload. The bit-packed routines load an
+/// 8-byte word starting at the byte holding the first bit of each entry.
+constexpr std::size_t PAYLOAD_PADDING{8};
+
+/// Accumulator type for sums of entries.
+using Acc = MatrixAccumulator<PackedIntMatrix::Elem>;
+
+/**
+ * Returns the number of payload bytes of a tile with the given width. A tile
+ * always fills a whole number of bytes, since it holds 256 entries.
+ */
+constexpr std::size_t tile_bytes(std::size_t width)
+{
+    return TILE_ENTRIES * width / 8;
+}
+
+/**
+ * Converts an integer between this processor's byte order and little endian.
+ */
+template<typename U>
+inline U to_little_endian(U value)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    if constexpr (sizeof(U) == 2) {
+        return __builtin_bswap16(value);
+    } else if constexpr (sizeof(U) == 4) {
+        return __builtin_bswap32(value);
+    } else if constexpr (sizeof(U) == 8) {
+        return __builtin_bswap64(value);
+    }
+#endif
+    return value;
+}
+
+/// Unsigned integer type with exactly the given number of bits, for the
+/// widths that are whole machine words.
+template<std::size_t W>
+using WordType = std::conditional_t<W == 8, std::uint8_t,
+    std::conditional_t<W == 16, std::uint16_t, std::uint32_t>>;
+
+/**
+ * Packs the offsets of one tile into tile_bytes(W) bytes of `out`.
+ *
+ * @tparam W Bits per offset. Every offset must be less than 2^W.
+ */
+template<std::size_t W>
+void pack_offsets(const std::uint32_t* offsets, std::uint8_t* out)
+{
+    if constexpr (W == 8 || W == 16 || W == 32) {
+        using U = WordType<W>;
+        for (std::size_t i{0}; i < TILE_ENTRIES; ++i) {
+            const U word{to_little_endian(static_cast<U>(offsets[i]))};
+            std::memcpy(out + i * sizeof(U), &word, sizeof(U));
+        }
+    } else if constexpr (W != 0) {
+        // Offsets are appended to a bit buffer from the low end, and whole
+        // bytes are flushed from the low end.
+        std::uint64_t bits{0};
+        std::size_t filled{0};
+        for (std::size_t i{0}; i < TILE_ENTRIES; ++i) {
+            bits |= std::uint64_t{offsets[i]} << filled;
+            filled += W;
+            while (filled >= 8) {
+                *out++ = static_cast<std::uint8_t>(bits);
+                bits >>= 8u;
+                filled -= 8;
+            }
+        }
+    }
+}
+
+/**
+ * Unpacks the offsets of one tile packed by pack_offsets<W>().
+ *
+ * The width is a template parameter, so the shifts and masks are constants
+ * and the loops have a constant trip count. The compiler fully unrolls or
+ * vectorizes each of them.
+ */
+template<std::size_t W>
+void unpack_offsets(const std::uint8_t* in, std::uint32_t* offsets)
+{
+    if constexpr (W == 0) {
+        std::fill(offsets, offsets + TILE_ENTRIES, std::uint32_t{0});
+    } else if constexpr (W == 8 || W == 16 || W == 32) {
+        using U = WordType<W>;
+        for (std::size_t i{0}; i < TILE_ENTRIES; ++i) {
+            U word;
+            std::memcpy(&word, in + i * sizeof(U), sizeof(U));
+            offsets[i] = to_little_endian(word);
+        }
+    } else {
+        constexpr std::uint64_t mask{(std::uint64_t{1} << W) - 1};
+        for (std::size_t i{0}; i < TILE_ENTRIES; ++i) {
+            // The entry starts at most 7 bits into the loaded word, and
+            // 7 + W bits always fit in 64 bits.
+            const std::size_t bit{i * W};
+            std::uint64_t word;
+            std::memcpy(&word, in + bit / 8, sizeof(word));
+            offsets[i] = static_cast<std::uint32_t>((to_little_endian(word) >> (bit % 8)) & mask);
+        }
+    }
+}
+
+using PackFn = void (*)(const std::uint32_t*, std::uint8_t*);
+
+using UnpackFn = void (*)(const std::uint8_t*, std::uint32_t*);
+
+template<std::size_t... Ws>
+constexpr std::array<PackFn, sizeof...(Ws)> make_pack_table(std::index_sequence<Ws...>)
+{
+    return {{&pack_offsets<Ws>...}};
+}
+
+template<std::size_t... Ws>
+constexpr std::array<UnpackFn, sizeof...(Ws)> make_unpack_table(std::index_sequence<Ws...>)
+{
+    return {{&unpack_offsets<Ws>...}};
+}
+
+/// Packing routine for each width from 0 to MAX_WIDTH.
+constexpr auto PACK_TABLE = make_pack_table(std::make_index_sequence<MAX_WIDTH + 1>{});
+
+/// Unpacking routine for each width from 0 to MAX_WIDTH.
+constexpr auto UNPACK_TABLE = make_unpack_table(std::make_index_sequence<MAX_WIDTH + 1>{});
+
+/**
+ * Returns the width used for tiles whose largest offset is `range`.
+ */
+unsigned width_for_range(std::uint32_t range, PackedWidths widths)
+{
+    const unsigned bits{range == 0 ? 0u : 32u - static_cast<unsigned>(__builtin_clz(range))};
+    if (widths == PackedWidths::Bits || bits == 0) {
+        return bits;
+    }
+    return bits <= 8 ? 8u : bits <= 16 ? 16u : 32u;
+}
+
+/**
+ * Returns the number of tiles needed to cover the given number of entries.
+ */
+std::size_t tiles_covering(std::size_t entries)
+{
+    return entries / TILE + (entries % TILE != 0 ? 1 : 0);
+}
+
+/**
+ * Returns the entry with the given offset from a tile base.
+ */
+inline PackedIntMatrix::Elem from_offset(std::int32_t base, std::uint32_t offset)
+{
+    return static_cast<PackedIntMatrix::Elem>(std::int64_t{base} + std::int64_t{offset});
+}
+
+} // end namespace
+
+PackedIntMatrix::PackedIntMatrix(std::size_t rows, std::size_t cols)
+    : m_rows{rows},
+      m_cols{cols},
+      m_tile_rows{tiles_covering(rows)},
+      m_tile_cols{tiles_covering(cols)},
+      m_bases(m_tile_rows * m_tile_cols),
+      m_widths(m_tile_rows * m_tile_cols) {}
+
+void PackedIntMatrix::allocate_payload()
+{
+    m_offsets.resize(m_widths.size() + 1);
+    m_offsets[0] = 0;
+    for (std::size_t i{0}; i < m_widths.size(); ++i) {
+        m_offsets[i + 1] = m_offsets[i] + tile_bytes(m_widths[i]);
+    }
+    m_payload.assign(m_offsets.back() + PAYLOAD_PADDING, std::uint8_t{0});
+}
+
+PackedIntMatrix::PackedIntMatrix(const IntMatrix& mat, PackedWidths widths)
+    : PackedIntMatrix(mat.rows(), mat.cols())
+{
+    // Returns the bounds of the entries of the given tile within the matrix.
+    const auto tile_extent = [this](std::size_t tile_row, std::size_t tile_col) {
+        return std::make_pair(
+            std::min(TILE, m_rows - tile_row * TILE),
+            std::min(TILE, m_cols - tile_col * TILE)
+        );
+    };
+
+    // The first pass finds the base and width of every tile, so that the
+    // payload can be allocated at its final size.
+    for (std::size_t tile_row{0}; tile_row < m_tile_rows; ++tile_row) {
+        for (std::size_t tile_col{0}; tile_col < m_tile_cols; ++tile_col) {
+            const auto extent = tile_extent(tile_row, tile_col);
+            const Elem* const first{mat.begin() + tile_row * TILE * m_cols + tile_col * TILE};
+
+            Elem low{*first};
+            Elem high{*first};
+            for (std::size_t i{0}; i < extent.first; ++i) {
+                for (std::size_t j{0}; j < extent.second; ++j) {
+                    low = std::min(low, first[i * m_cols + j]);
+                    high = std::max(high, first[i * m_cols + j]);
+                }
+            }
+
+            const std::size_t tile{tile_row * m_tile_cols + tile_col};
+            m_bases[tile] = low;
+            m_widths[tile] = static_cast<std::uint8_t>(width_for_range(
+                static_cast<std::uint32_t>(high) - static_cast<std::uint32_t>(low), widths
+            ));
+        }
+    }
+    allocate_payload();
+
+    // The second pass computes the offsets of each tile and packs them.
+    std::uint32_t offsets[TILE_ENTRIES];
+    for (std::size_t tile_row{0}; tile_row < m_tile_rows; ++tile_row) {
+        for (std::size_t tile_col{0}; tile_col < m_tile_cols; ++tile_col) {
+            const auto extent = tile_extent(tile_row, tile_col);
+            const Elem* const first{mat.begin() + tile_row * TILE * m_cols + tile_col * TILE};
+            const std::size_t tile{tile_row * m_tile_cols + tile_col};
+            const auto base = static_cast<std::uint32_t>(m_bases[tile]);
+
+            std::fill(offsets, offsets + TILE_ENTRIES, std::uint32_t{0});
+            for (std::size_t i{0}; i < extent.first; ++i) {
+                for (std::size_t j{0}; j < extent.second; ++j) {
+                    offsets[i * TILE + j] = static_cast<std::uint32_t>(first[i * m_cols + j]) - base;
+                }
+            }
+            PACK_TABLE[m_widths[tile]](offsets, m_payload.data() + m_offsets[tile]);
+        }
+    }
+}
+
+void PackedIntMatrix::unpack_tile(std::size_t tile_row, std::size_t tile_col, std::uint32_t* offsets) const
+{
+    const std::size_t tile{tile_row * m_tile_cols + tile_col};
+    UNPACK_TABLE[m_widths[tile]](m_payload.data() + m_offsets[tile], offsets);
+}
+
+IntMatrix PackedIntMatrix::to_matrix() const
+{
+    IntMatrix mat(m_rows, m_cols);
+
+    std::uint32_t offsets[TILE_ENTRIES];
+    for (std::size_t tile_row{0}; tile_row < m_tile_rows; ++tile_row) {
+        const std::size_t row_count{std::min(TILE, m_rows - tile_row * TILE)};
+        for (std::size_t tile_col{0}; tile_col < m_tile_cols; ++tile_col) {
+            const std::size_t col_count{std::min(TILE, m_cols - tile_col * TILE)};
+            const std::int32_t base{tile_base(tile_row, tile_col)};
+            unpack_tile(tile_row, tile_col, offsets);
+
+            Elem* const first{mat.begin() + tile_row * TILE * m_cols + tile_col * TILE};
+            for (std::size_t i{0}; i < row_count; ++i) {
+                for (std::size_t j{0}; j < col_count; ++j) {
+                    first[i * m_cols + j] = from_offset(base, offsets[i * TILE + j]);
+                }
+            }
+        }
+    }
+    return mat;
+}
+
+PackedIntMatrix::Elem PackedIntMatrix::at(std::size_t row, std::size_t col) const
+{
+    if (row >= m_rows || col >= m_cols) {
+        throw std::out_of_range("invalid matrix index");
+    }
+
+    const std::size_t tile{(row / TILE) * m_tile_cols + col / TILE};
+    const std::size_t width{m_widths[tile]};
+    const std::size_t bit{((row % TILE) * TILE + col % TILE) * width};
+
+    // Every width is packed as a little endian bit stream, so one entry can
+    // be extracted the same way for all of them.
+    std::uint64_t word;
+    std::memcpy(&word, m_payload.data() + m_offsets[tile] + bit / 8, sizeof(word));
+    const std::uint64_t mask{(std::uint64_t{1} << width) - 1};
+    const auto offset = static_cast<std::uint32_t>((to_little_endian(word) >> (bit % 8)) & mask);
+    return from_offset(m_bases[tile], offset);
+}
+
+PackedIntMatrix PackedIntMatrix::transpose() const
+{
+    PackedIntMatrix result(m_cols, m_rows);
+
+    // Tile (i, j) of this matrix becomes tile (j, i) of the result, with the
+    // same base and width.
+    for (std::size_t tile_row{0}; tile_row < m_tile_rows; ++tile_row) {
+        for (std::size_t tile_col{0}; tile_col < m_tile_cols; ++tile_col) {
+            const std::size_t tile{tile_row * m_tile_cols + tile_col};
+            const std::size_t result_tile{tile_col * m_tile_rows + tile_row};
+            result.m_bases[result_tile] = m_bases[tile];
+            result.m_widths[result_tile] = m_widths[tile];
+        }
+    }
+    result.allocate_payload();
+
+    // Padding offsets are 0, so they remain valid padding once transposed.
+    std::uint32_t offsets[TILE_ENTRIES];
+    std::uint32_t transposed[TILE_ENTRIES];
+    for (std::size_t tile_row{0}; tile_row < m_tile_rows; ++tile_row) {
+        for (std::size_t tile_col{0}; tile_col < m_tile_cols; ++tile_col) {
+            const std::size_t tile{tile_row * m_tile_cols + tile_col};
+            const std::size_t result_tile{tile_col * m_tile_rows + tile_row};
+            if (m_widths[tile] == 0) {
+                // Constant tiles have no payload.
+                continue;
+            }
+
+            UNPACK_TABLE[m_widths[tile]](m_payload.data() + m_offsets[tile], offsets);
+            for (std::size_t i{0}; i < TILE; ++i) {
+                for (std::size_t j{0}; j < TILE; ++j) {
+                    transposed[j * TILE + i] = offsets[i * TILE + j];
+                }
+            }
+            PACK_TABLE[m_widths[tile]](
+                transposed, result.m_payload.data() + result.m_offsets[result_tile]
+            );
+        }
+    }
+    return result;
+}
+
+std::size_t PackedIntMatrix::packed_bytes() const
+{
+    return m_payload.size()
+        + m_bases.size() * sizeof(std::int32_t)
+        + m_widths.size() * sizeof(std::uint8_t)
+        + m_offsets.size() * sizeof(std::size_t);
+}
+
+void write_packed_matrix_file(const char* path, const PackedIntMatrix& mat)
+{
+    PackedMatrixFileHeader header{};
+    std::memcpy(header.magic, PackedMatrixFileHeader::MAGIC, sizeof(header.magic));
+    header.version = PackedMatrixFileHeader::VERSION;
+    header.tile = static_cast<std::uint8_t>(PackedIntMatrix::TILE);
+    header.byte_order = native_byte_order();
+    header.rows = mat.m_rows;
+    header.cols = mat.m_cols;
+    header.payload_bytes = mat.m_offsets.back();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(
+        reinterpret_cast<const char*>(mat.m_bases.data()),
+        static_cast<std::streamsize>(mat.m_bases.size() * sizeof(std::int32_t))
+    );
+    out.write(
+        reinterpret_cast<const char*>(mat.m_widths.data()),
+        static_cast<std::streamsize>(mat.m_widths.size())
+    );
+    out.write(
+        reinterpret_cast<const char*>(mat.m_payload.data()),
+        static_cast<std::streamsize>(header.payload_bytes)
+    );
+    out.close();
+
+    if (!out) {
+        throw MatrixFileError("failed to write matrix file");
+    }
+}
+
+PackedIntMatrix read_packed_matrix_file(const char* path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw MatrixFileError("failed to open matrix file");
+    }
+    const auto file_size = static_cast<std::size_t>(in.tellg());
+    in.seekg(0);
+
+    PackedMatrixFileHeader header{};
+    if (file_size < sizeof(header) || !in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw MatrixFileError("matrix file is truncated");
+    }
+    if (std::memcmp(header.magic, PackedMatrixFileHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw MatrixFileError("not a packed matrix file");
+    }
+    if (header.byte_order != native_byte_order()) {
+        throw MatrixFileError("matrix file byte order does not match this processor");
+    }
+    if (header.version != PackedMatrixFileHeader::VERSION || header.tile != PackedIntMatrix::TILE) {
+        throw MatrixFileError("unsupported matrix file version");
+    }
+
+    // Check the tile count against the file size before allocating anything,
+    // so that corrupt dimensions cannot cause huge allocations.
+    constexpr std::size_t max_dimension{std::numeric_limits<std::size_t>::max() / 2};
+    if (header.rows > max_dimension || header.cols > max_dimension) {
+        throw MatrixFileError("matrix file is truncated");
+    }
+    const std::size_t tile_rows{tiles_covering(header.rows)};
+    const std::size_t tile_cols{tiles_covering(header.cols)};
+    const std::size_t tile_data{sizeof(std::int32_t) + sizeof(std::uint8_t)};
+    const std::size_t capacity{(file_size - sizeof(header)) / tile_data};
+    if (tile_cols != 0 && tile_rows > capacity / tile_cols) {
+        throw MatrixFileError("matrix file is truncated");
+    }
+    if (header.payload_bytes != file_size - sizeof(header) - tile_rows * tile_cols * tile_data) {
+        throw MatrixFileError("matrix file is truncated");
+    }
+
+    PackedIntMatrix mat(header.rows, header.cols);
+    in.read(
+        reinterpret_cast<char*>(mat.m_bases.data()),
+        static_cast<std::streamsize>(mat.m_bases.size() * sizeof(std::int32_t))
+    );
+    in.read(
+        reinterpret_cast<char*>(mat.m_widths.data()),
+        static_cast<std::streamsize>(mat.m_widths.size())
+    );
+    for (const auto width : mat.m_widths) {
+        if (width > MAX_WIDTH) {
+            throw MatrixFileError("matrix file has an invalid tile width");
+        }
+    }
+
+    mat.allocate_payload();
+    if (mat.m_offsets.back() != header.payload_bytes) {
+        throw MatrixFileError("matrix file payload does not match its tile widths");
+    }
+    in.read(
+        reinterpret_cast<char*>(mat.m_payload.data()),
+        static_cast<std::streamsize>(header.payload_bytes)
+    );
+
+    if (!in) {
+        throw MatrixFileError("failed to read matrix file");
+    }
+    return mat;
+}
+
+Acc sum(const PackedIntMatrix& mat)
+{
+    // Padding offsets are 0, so each tile contributes its base once per entry
+    // inside the matrix plus the sum of all of its offsets.
+    std::uint32_t offsets[TILE_ENTRIES];
+    Acc total{0};
+    for (std::size_t tile_row{0}; tile_row < mat.tile_rows(); ++tile_row) {
+        const std::size_t row_count{std::min(TILE, mat.rows() - tile_row * TILE)};
+        for (std::size_t tile_col{0}; tile_col < mat.tile_cols(); ++tile_col) {
+            const std::size_t col_count{std::min(TILE, mat.cols() - tile_col * TILE)};
+            mat.unpack_tile(tile_row, tile_col, offsets);
+
+            std::uint64_t offset_sum{0};
+            for (std::size_t i{0}; i < TILE_ENTRIES; ++i) {
+                offset_sum += offsets[i];
+            }
+            total += static_cast<Acc>(row_count * col_count) * Acc{mat.tile_base(tile_row, tile_col)}
+                + static_cast<Acc>(offset_sum);
+        }
+    }
+    return total;
+}
+
+std::vector<Acc> row_sums(const PackedIntMatrix& mat)
+{
+    std::uint32_t offsets[TILE_ENTRIES];
+    std::vector<Acc> sums(mat.rows());
+    for (std::size_t tile_row{0}; tile_row < mat.tile_rows(); ++tile_row) {
+        const std::size_t row_count{std::min(TILE, mat.rows() - tile_row * TILE)};
+        for (std::size_t tile_col{0}; tile_col < mat.tile_cols(); ++tile_col) {
+            const std::size_t col_count{std::min(TILE, mat.cols() - tile_col * TILE)};
+            const Acc base_sum{static_cast<Acc>(col_count) * Acc{mat.tile_base(tile_row, tile_col)}};
+            mat.unpack_tile(tile_row, tile_col, offsets);
+
+            for (std::size_t i{0}; i < row_count; ++i) {
+                std::uint64_t offset_sum{0};
+                for (std::size_t j{0}; j < TILE; ++j) {
+                    offset_sum += offsets[i * TILE + j];
+                }
+                sums[tile_row * TILE + i] += base_sum + static_cast<Acc>(offset_sum);
+            }
+        }
+    }
+    return sums;
+}
+
+std::vector<Acc> col_sums(const PackedIntMatrix& mat)
+{
+    std::uint32_t offsets[TILE_ENTRIES];
+    std::vector<Acc> sums(mat.cols());
+    for (std::size_t tile_row{0}; tile_row < mat.tile_rows(); ++tile_row) {
+        const std::size_t row_count{std::min(TILE, mat.rows() - tile_row * TILE)};
+        for (std::size_t tile_col{0}; tile_col < mat.tile_cols(); ++tile_col) {
+            const std::size_t col_count{std::min(TILE, mat.cols() - tile_col * TILE)};
+            const Acc base_sum{static_cast<Acc>(row_count) * Acc{mat.tile_base(tile_row, tile_col)}};
+            mat.unpack_tile(tile_row, tile_col, offsets);
+
+            // Sum down the columns of the tile a row at a time.
+            std::uint64_t offset_sums[TILE]{};
+            for (std::size_t i{0}; i < TILE; ++i) {
+                for (std::size_t j{0}; j < TILE; ++j) {
+                    offset_sums[j] += offsets[i * TILE + j];
+                }
+            }
+            for (std::size_t j{0}; j < col_count; ++j) {
+                sums[tile_col * TILE + j] += base_sum + static_cast<Acc>(offset_sums[j]);
+            }
+        }
+    }
+    return sums;
+}
+
+std::pair<PackedIntMatrix::Elem, PackedIntMatrix::Elem> min_max(const PackedIntMatrix& mat)
+{
+    if (mat.rows() == 0 || mat.cols() == 0) {
+        throw std::invalid_argument("matrix has no entries");
+    }
+
+    // The base of each tile is its smallest entry, so only the largest
+    // offset of each tile must be found.
+    std::uint32_t offsets[TILE_ENTRIES];
+    PackedIntMatrix::Elem low{mat.tile_base(0, 0)};
+    PackedIntMatrix::Elem high{mat.tile_base(0, 0)};
+    for (std::size_t tile_row{0}; tile_row < mat.tile_rows(); ++tile_row) {
+        for (std::size_t tile_col{0}; tile_col < mat.tile_cols(); ++tile_col) {
+            const std::int32_t base{mat.tile_base(tile_row, tile_col)};
+            low = std::min(low, base);
+            if (mat.tile_width(tile_row, tile_col) == 0) {
+                high = std::max(high, base);
+                continue;
+            }
+
+            mat.unpack_tile(tile_row, tile_col, offsets);
+            std::uint32_t largest{0};
+            for (std::size_t i{0}; i < TILE_ENTRIES; ++i) {
+                largest = std::max(largest, offsets[i]);
+            }
+            high = std::max(high, from_offset(base, largest));
+        }
+    }
+    return {low, high};
+}
+
+Acc trace(const PackedIntMatrix& mat)
+{
+    if (mat.rows() != mat.cols()) {
+        throw std::logic_error("matrix must be square");
+    }
+
+    Acc total{0};
+    for (std::size_t i{0}; i < mat.rows(); ++i) {
+        total += static_cast<Acc>(mat.at(i, i));
+    }
+    return total;
+}
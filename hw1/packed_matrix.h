@@ -0,0 +1,284 @@
+/*
+ * ECEE 2160 Homework assignment 1 packed integer matrix declarations.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - D. Lemire and L. Boytsov, "Decoding billions of integers per second
+ *    through vectorization," Softw. Pract. Exper., vol. 45, no. 1, 2015.
+ *  - J. Goldstein, R. Ramakrishnan and U. Shaft, "Compressing relations and
+ *    indexes," in Proc. ICDE, 1998. (frame of reference coding)
+ *
+ * File Format
+ * ===========
+ *
+ * A packed matrix file begins with a 64-byte header, followed by the base of
+ * each tile as a 32-bit integer, the width of each tile as one byte, and the
+ * packed payload. Tiles are stored in row-major order of the tile grid. The
+ * header fields and tile bases are written in the byte order recorded by the
+ * header. The payload is a little endian bit stream on every processor.
+ *
+ *   Offset  Size  Field
+ *   0       8     Magic bytes "ECEEPAK" followed by a NUL byte
+ *   8       4     Format version (currently 1)
+ *   12      1     Tile edge length (currently 16)
+ *   13      1     Byte order of the writer (1 = little, 2 = big)
+ *   14      2     Reserved, zero
+ *   16      8     Number of rows
+ *   24      8     Number of columns
+ *   32      8     Size of the payload in bytes
+ *   40      24    Reserved, zero
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_PACKED_MATRIX_H
+#define ECEE_2160_HOMEWORK_PACKED_MATRIX_H
+
+#include "matrix.h"
+#include "matrix_file.h"
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t, std::uint8_t, std::uint32_t
+#include <utility>      // for std::pair
+#include <vector>       // for std::vector
+
+static_assert(sizeof(IntMatrix::Elem) == sizeof(std::int32_t), "IntMatrix entries must be 32 bits.");
+
+/**
+ * Specifies which bit widths a PackedIntMatrix may use for its tiles.
+ */
+enum class PackedWidths {
+    /// Any width from 0 to 32 bits. Gives the smallest matrices.
+    Bits,
+    /// Only 0, 8, 16 or 32 bits. Packs and unpacks with plain loads and
+    /// stores, at the cost of up to 7 wasted bits per entry.
+    Bytes,
+};
+
+/**
+ * An integer matrix whose entries are stored with frame of reference
+ * bit-packing.
+ *
+ * The matrix is divided into square tiles of TILE by TILE entries. Each tile
+ * stores its smallest entry, the base, and the offset of every entry from
+ * the base using the fewest bits that can hold the largest offset in the
+ * tile. A tile whose entries fit in 8 bits, or lie within 255 of each other,
+ * occupies a quarter of its unpacked size. A constant tile occupies no
+ * payload at all. Tiles that extend past the last row or column are padded
+ * with offsets of 0.
+ *
+ * Packed matrices are read-only. Transposes and reductions work on one tile
+ * at a time, unpacking it into a small buffer, so the matrix is never
+ * widened as a whole.
+ */
+class PackedIntMatrix {
+    /// The number of rows in this matrix
+    std::size_t m_rows;
+
+    /// The number of columns per row.
+    std::size_t m_cols;
+
+    /// The number of rows of tiles.
+    std::size_t m_tile_rows;
+
+    /// The number of columns of tiles.
+    std::size_t m_tile_cols;
+
+    /// Smallest entry of each tile.
+    std::vector<std::int32_t> m_bases;
+
+    /// Bits per entry of each tile.
+    std::vector<std::uint8_t> m_widths;
+
+    /// Start of each tile in m_payload, plus the payload size.
+    std::vector<std::size_t> m_offsets;
+
+    /// Packed offsets of all tiles, followed by padding that lets the
+    /// unpacking routines load whole words past the end of the last tile.
+    std::vector<std::uint8_t> m_payload;
+
+    /**
+     * Constructs a matrix with the given dimensions and unset tiles.
+     */
+    PackedIntMatrix(std::size_t rows, std::size_t cols);
+
+    /**
+     * Sets m_offsets from m_widths and allocates the payload.
+     */
+    void allocate_payload();
+
+  public:
+    /// Data type for matrix entries.
+    using Elem = IntMatrix::Elem;
+
+    /// Edge length of a tile.
+    static constexpr std::size_t TILE{16};
+
+    /// Number of entries in a tile.
+    static constexpr std::size_t TILE_ENTRIES{TILE * TILE};
+
+    /**
+     * Constructs a packed copy of the given matrix.
+     *
+     * @param mat Matrix to pack.
+     * @param widths Bit widths the tiles may use.
+     */
+    explicit PackedIntMatrix(const IntMatrix& mat, PackedWidths widths = PackedWidths::Bits);
+
+    /**
+     * Returns an unpacked copy of this matrix.
+     */
+    IntMatrix to_matrix() const;
+
+    /**
+     * Returns the entry at the given position.
+     *
+     * This function raises std::out_of_range if the position is outside the
+     * matrix.
+     */
+    Elem at(std::size_t row, std::size_t col) const;
+
+    /**
+     * Returns the transpose of this matrix.
+     *
+     * Each tile is unpacked, transposed, and packed again with the same base
+     * and width, so the transpose occupies exactly as much memory as this
+     * matrix.
+     */
+    PackedIntMatrix transpose() const;
+
+    /**
+     * Returns the number of rows in the matrix.
+     */
+    std::size_t rows() const { return m_rows; }
+
+    /**
+     * Returns the number of columns in the matrix.
+     */
+    std::size_t cols() const { return m_cols; }
+
+    /**
+     * Returns the number of rows of tiles.
+     */
+    std::size_t tile_rows() const { return m_tile_rows; }
+
+    /**
+     * Returns the number of columns of tiles.
+     */
+    std::size_t tile_cols() const { return m_tile_cols; }
+
+    /**
+     * Returns the number of bytes used by the payload and per-tile data.
+     */
+    std::size_t packed_bytes() const;
+
+    /**
+     * Returns the smallest entry of the given tile.
+     */
+    std::int32_t tile_base(std::size_t tile_row, std::size_t tile_col) const
+    {
+        return m_bases[tile_row * m_tile_cols + tile_col];
+    }
+
+    /**
+     * Returns the bits per entry of the given tile.
+     */
+    unsigned tile_width(std::size_t tile_row, std::size_t tile_col) const
+    {
+        return m_widths[tile_row * m_tile_cols + tile_col];
+    }
+
+    /**
+     * Unpacks the offsets of the entries of the given tile from its base.
+     *
+     * @param offsets Destination for TILE_ENTRIES offsets in row-major order.
+     *                Entry (i, j) of the tile equals the base plus
+     *                offsets[i * TILE + j], computed without overflow.
+     */
+    void unpack_tile(std::size_t tile_row, std::size_t tile_col, std::uint32_t* offsets) const;
+
+    friend void write_packed_matrix_file(const char* path, const PackedIntMatrix& mat);
+
+    friend PackedIntMatrix read_packed_matrix_file(const char* path);
+};
+
+/**
+ * Header of a packed matrix file, laid out exactly as stored on disk.
+ */
+struct PackedMatrixFileHeader {
+    /// Magic bytes identifying a packed matrix file.
+    static constexpr char MAGIC[8] = {'E', 'C', 'E', 'E', 'P', 'A', 'K', '\0'};
+
+    /// Version of the format described above.
+    static constexpr std::uint32_t VERSION{1};
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint8_t tile;
+    MatrixFileByteOrder byte_order;
+    std::uint16_t reserved_0;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t payload_bytes;
+    std::uint8_t reserved_1[24];
+};
+
+static_assert(sizeof(PackedMatrixFileHeader) == 64, "PackedMatrixFileHeader must occupy 64 bytes.");
+
+/**
+ * Writes the given packed matrix to a packed matrix file at the given path,
+ * replacing any existing file. The tiles are written as they are stored,
+ * without unpacking.
+ *
+ * @throws MatrixFileError if the file cannot be written.
+ */
+void write_packed_matrix_file(const char* path, const PackedIntMatrix& mat);
+
+/**
+ * Reads the packed matrix file at the given path.
+ *
+ * @throws MatrixFileError if the file cannot be read, or is not a well-formed
+ *         packed matrix file in this processor's byte order.
+ */
+PackedIntMatrix read_packed_matrix_file(const char* path);
+
+/*
+ * Reductions over the entries of a packed matrix, matching those declared in
+ * matrix_reduce.h. Each tile is unpacked into a local buffer and its offsets
+ * are summed before the base is added back, so the reductions read only the
+ * packed bytes. The minimum is read directly from the tile bases.
+ */
+
+/**
+ * Returns the sum of all entries of the given matrix.
+ */
+MatrixAccumulator<PackedIntMatrix::Elem> sum(const PackedIntMatrix& mat);
+
+/**
+ * Returns the sum of each row of the given matrix.
+ */
+std::vector<MatrixAccumulator<PackedIntMatrix::Elem>> row_sums(const PackedIntMatrix& mat);
+
+/**
+ * Returns the sum of each column of the given matrix.
+ */
+std::vector<MatrixAccumulator<PackedIntMatrix::Elem>> col_sums(const PackedIntMatrix& mat);
+
+/**
+ * Returns the smallest and largest entries of the given matrix.
+ *
+ * This function raises std::invalid_argument if the matrix has no entries.
+ */
+std::pair<PackedIntMatrix::Elem, PackedIntMatrix::Elem> min_max(const PackedIntMatrix& mat);
+
+/**
+ * Returns the sum of the diagonal entries of the given matrix.
+ *
+ * This function raises std::logic_error if the matrix is not square.
+ */
+MatrixAccumulator<PackedIntMatrix::Elem> trace(const PackedIntMatrix& mat);
+
+#endif //ECEE_2160_HOMEWORK_PACKED_MATRIX_H
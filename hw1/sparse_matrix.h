@@ -0,0 +1,136 @@
+/*
+ * ECEE 2160 Homework assignment 1 compressed sparse row matrix declarations.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - https://en.wikipedia.org/wiki/Sparse_matrix#Compressed_sparse_row_(CSR,_CRS_or_Yale_format)
+ *  - F. G. Gustavson, "Two fast algorithms for sparse matrices:
+ *    multiplication and permuted transposition," ACM Trans. Math. Softw.,
+ *    vol. 4, no. 3, 1978.
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_SPARSE_MATRIX_H
+#define ECEE_2160_HOMEWORK_SPARSE_MATRIX_H
+
+#include "matrix.h"
+
+#include <cstddef>      // for std::size_t
+#include <iosfwd>       // for std::ostream (no definitions)
+#include <vector>       // for std::vector
+
+/**
+ * A sparse matrix stored in compressed sparse row (CSR) form.
+ *
+ * Only nonzero entries are stored. The nonzero entries of row `i` occupy
+ * positions [row_offsets()[i], row_offsets()[i + 1]) of values(), with their
+ * column indices at the same positions of col_indices(). Column indices are
+ * strictly increasing within each row.
+ *
+ * @tparam T Data type of matrix entries.
+ */
+template<typename T>
+class CsrMatrix {
+    /// The number of rows in this matrix
+    std::size_t m_rows;
+
+    /// The number of columns per row.
+    std::size_t m_cols;
+
+    /// Start of each row in m_col_indices and m_values, plus the total count.
+    std::vector<std::size_t> m_row_offsets;
+
+    /// Column index of each nonzero entry.
+    std::vector<std::size_t> m_col_indices;
+
+    /// Value of each nonzero entry.
+    std::vector<T> m_values;
+
+  public:
+    /// Data type for matrix entries.
+    using Elem = T;
+
+    /**
+     * Constructs a matrix with the given dimensions and no nonzero entries.
+     */
+    CsrMatrix(std::size_t rows, std::size_t cols);
+
+    /**
+     * Constructs a sparse matrix holding the nonzero entries of the given
+     * dense matrix.
+     */
+    explicit CsrMatrix(const Matrix<T>& dense);
+
+    /**
+     * Returns a dense matrix holding the entries of this matrix.
+     */
+    Matrix<T> to_dense() const;
+
+    /**
+     * Returns the transpose of this matrix.
+     *
+     * The nonzero entries are redistributed with a counting sort on their
+     * column indices, which runs in O(nnz + rows + cols) time. Scanning the
+     * rows in order leaves the column indices of each output row sorted.
+     */
+    CsrMatrix transpose() const;
+
+    /**
+     * Computes the sparse matrix-vector product y = A x.
+     *
+     * Each entry of `y` is accumulated in MatrixWrappingAccumulator<T> and
+     * narrowed once. The rows are divided between threads so that every thread
+     * receives about the same number of nonzero entries, which keeps the
+     * work balanced when nonzero entries are concentrated in a few rows.
+     *
+     * @param x Input vector with cols() entries.
+     * @param y Output vector with rows() entries. Must not overlap `x`.
+     * @param thread_count Number of threads, or 0 to use one thread per
+     *                     hardware thread.
+     */
+    void multiply(const T* x, T* y, std::size_t thread_count = 1) const;
+
+    /**
+     * Returns the number of rows in the matrix.
+     */
+    std::size_t rows() const { return m_rows; }
+
+    /**
+     * Returns the number of columns in the matrix.
+     */
+    std::size_t cols() const { return m_cols; }
+
+    /**
+     * Returns the number of stored nonzero entries.
+     */
+    std::size_t nonzeros() const { return m_values.size(); }
+
+    const std::vector<std::size_t>& row_offsets() const { return m_row_offsets; }
+
+    const std::vector<std::size_t>& col_indices() const { return m_col_indices; }
+
+    const std::vector<T>& values() const { return m_values; }
+
+    /*
+     * I/O stream operators.
+     *
+     * Sparse matrices are written and read in the same dense text layout as
+     * Matrix, so the two types can exchange text. Reading skips zero entries
+     * and keeps the dimensions of the destination matrix. If reading fails,
+     * the stream's failbit is set and the matrix holds the entries read so
+     * far, with every later entry zero.
+     */
+    template<typename U>
+    friend std::ostream& operator<<(std::ostream& out, const CsrMatrix<U>& mat);
+
+    template<typename U>
+    friend std::istream& operator>>(std::istream& in, CsrMatrix<U>& mat);
+};
+
+#include "sparse_matrix.tpp"
+
+#endif //ECEE_2160_HOMEWORK_SPARSE_MATRIX_H
@@ -0,0 +1,190 @@
+/*
+ * ECEE 2160 Homework assignment 1 compressed sparse row matrix definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include <algorithm>    // for std::fill, std::max, std::min, std::upper_bound
+#include <istream>      // for std::istream
+#include <ostream>      // for std::ostream
+#include <thread>       // for std::thread
+
+template<typename T>
+CsrMatrix<T>::CsrMatrix(std::size_t rows, std::size_t cols)
+    : m_rows{rows}, m_cols{cols}, m_row_offsets(rows + 1, 0) {}
+
+template<typename T>
+CsrMatrix<T>::CsrMatrix(const Matrix<T>& dense) : CsrMatrix(dense.rows(), dense.cols())
+{
+    const T* entry{dense.begin()};
+    for (std::size_t i_row{0}; i_row < m_rows; ++i_row) {
+        for (std::size_t i_col{0}; i_col < m_cols; ++i_col, ++entry) {
+            if (*entry != T{}) {
+                m_col_indices.push_back(i_col);
+                m_values.push_back(*entry);
+            }
+        }
+        m_row_offsets[i_row + 1] = m_values.size();
+    }
+}
+
+template<typename T>
+Matrix<T> CsrMatrix<T>::to_dense() const
+{
+    Matrix<T> dense(m_rows, m_cols);
+    std::fill(dense.begin(), dense.end(), T{});
+
+    T* row{dense.begin()};
+    for (std::size_t i_row{0}; i_row < m_rows; ++i_row, row += m_cols) {
+        for (std::size_t i{m_row_offsets[i_row]}; i < m_row_offsets[i_row + 1]; ++i) {
+            row[m_col_indices[i]] = m_values[i];
+        }
+    }
+    return dense;
+}
+
+template<typename T>
+CsrMatrix<T> CsrMatrix<T>::transpose() const
+{
+    CsrMatrix result(m_cols, m_rows);
+    result.m_col_indices.resize(nonzeros());
+    result.m_values.resize(nonzeros());
+
+    // Count the nonzero entries in each column, which become the rows of the
+    // transpose. Counts are stored one position ahead so that the prefix sum
+    // below yields the starting offset of each row.
+    for (const auto col : m_col_indices) {
+        ++result.m_row_offsets[col + 1];
+    }
+    for (std::size_t i{0}; i < m_cols; ++i) {
+        result.m_row_offsets[i + 1] += result.m_row_offsets[i];
+    }
+
+    // Scatter each entry to the next free slot of its output row. Visiting
+    // source rows in increasing order keeps each output row sorted.
+    std::vector<std::size_t> next(result.m_row_offsets.begin(), result.m_row_offsets.end() - 1);
+    for (std::size_t i_row{0}; i_row < m_rows; ++i_row) {
+        for (std::size_t i{m_row_offsets[i_row]}; i < m_row_offsets[i_row + 1]; ++i) {
+            const std::size_t slot{next[m_col_indices[i]]++};
+            result.m_col_indices[slot] = i_row;
+            result.m_values[slot] = m_values[i];
+        }
+    }
+    return result;
+}
+
+template<typename T>
+void CsrMatrix<T>::multiply(const T* x, T* y, std::size_t thread_count) const
+{
+    using Acc = MatrixWrappingAccumulator<T>;
+
+    // Computes the entries of y for rows [first, last).
+    const auto multiply_rows = [this, x, y](std::size_t first, std::size_t last) {
+        for (std::size_t i_row{first}; i_row < last; ++i_row) {
+            Acc sum{};
+            for (std::size_t i{m_row_offsets[i_row]}; i < m_row_offsets[i_row + 1]; ++i) {
+                sum += static_cast<Acc>(m_values[i]) * static_cast<Acc>(x[m_col_indices[i]]);
+            }
+            y[i_row] = static_cast<T>(sum);
+        }
+    };
+
+    if (thread_count == 0) {
+        // hardware_concurrency() may return 0 if the count is unknown.
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    thread_count = std::min(thread_count, std::max(m_rows, std::size_t{1}));
+
+    // Returns the first row of the given thread's range, chosen so that each
+    // range holds about the same number of nonzero entries. The first range
+    // starts at row 0 and the last ends at the last row, so that empty rows
+    // at either end are still written, and the range starts never decrease,
+    // so every row belongs to exactly one range.
+    const auto range_start = [this, thread_count](std::size_t thread_index) {
+        if (thread_index == 0) {
+            return std::size_t{0};
+        }
+        if (thread_index == thread_count) {
+            return m_rows;
+        }
+        const std::size_t target{nonzeros() * thread_index / thread_count};
+        const auto row = std::upper_bound(m_row_offsets.begin(), m_row_offsets.end(), target);
+        return std::min(static_cast<std::size_t>(row - m_row_offsets.begin()) - 1, m_rows);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count - 1);
+    for (std::size_t i{1}; i < thread_count; ++i) {
+        workers.emplace_back(multiply_rows, range_start(i), range_start(i + 1));
+    }
+
+    // The calling thread processes the first range.
+    multiply_rows(range_start(0), range_start(1));
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+template<typename U>
+std::ostream& operator<<(std::ostream& out, const CsrMatrix<U>& mat)
+{
+    for (std::size_t i_row{0}; i_row < mat.m_rows; ++i_row) {
+        std::size_t i{mat.m_row_offsets[i_row]};
+        for (std::size_t i_col{0}; i_col < mat.m_cols; ++i_col) {
+            // Print the stored entry if this column holds one, else a zero.
+            U elem{};
+            if (i < mat.m_row_offsets[i_row + 1] && mat.m_col_indices[i] == i_col) {
+                elem = mat.m_values[i++];
+            }
+            // If this is the last column of a row, print a newline.
+            //
+            // Unary plus promotes character-sized integers so that they are
+            // printed as numbers.
+            out << +elem << (i_col + 1 == mat.m_cols ? "\n" : matrix_detail::DELIM);
+        }
+    }
+    return out;
+}
+
+template<typename U>
+std::istream& operator>>(std::istream& in, CsrMatrix<U>& mat)
+{
+    // Read character-sized integers as numbers through their promoted type.
+    using Promoted = decltype(+U{});
+
+    mat.m_col_indices.clear();
+    mat.m_values.clear();
+    std::fill(mat.m_row_offsets.begin(), mat.m_row_offsets.end(), 0);
+
+    // On failure, ends the rows that were not read at the last entry read, so
+    // that the row offsets stay nondecreasing and the matrix stays valid.
+    const auto fail_from_row = [&](std::size_t i_row) -> std::istream& {
+        std::fill(mat.m_row_offsets.begin() + static_cast<std::ptrdiff_t>(i_row) + 1,
+                  mat.m_row_offsets.end(), mat.m_values.size());
+        in.setstate(std::ios_base::failbit);
+        return in;
+    };
+
+    for (std::size_t i_row{0}; i_row < mat.m_rows; ++i_row) {
+        for (std::size_t i_col{0}; i_col < mat.m_cols; ++i_col) {
+            Promoted value{};
+            if (!(in >> value)) {
+                return fail_from_row(i_row);
+            }
+            const auto elem = static_cast<U>(value);
+            // Fail if the value does not fit in the entry type.
+            if (static_cast<Promoted>(elem) != value) {
+                return fail_from_row(i_row);
+            }
+            if (elem != U{}) {
+                mat.m_col_indices.push_back(i_col);
+                mat.m_values.push_back(elem);
+            }
+        }
+        mat.m_row_offsets[i_row + 1] = mat.m_values.size();
+    }
+    return in;
+}
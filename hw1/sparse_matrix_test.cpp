@@ -0,0 +1,215 @@
+/*
+ * ECEE 2160 Homework assignment 1 compressed sparse row matrix tests.
+ *
+ * Builds sparse matrices from dense matrices with several sparsity patterns,
+ * including empty rows and columns at either end, a matrix whose nonzero
+ * entries all lie in one row, and a matrix with no nonzero entries. The
+ * transpose and the matrix-vector product are checked against the same
+ * operations on the dense matrix, with thread counts up to more threads than
+ * rows. The dense text layout is checked to round-trip.
+ *
+ * Failures are written to standard error, and the exit status is nonzero if
+ * any check fails.
+ *
+ * Usage: hw1-sparse-matrix-test
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "matrix.h"
+#include "sparse_matrix.h"
+#include "test_checker.h"
+
+#include <algorithm>    // for std::equal, std::is_sorted
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int8_t, std::int64_t
+#include <sstream>      // for std::stringstream
+#include <vector>       // for std::vector
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Matrix shapes tested, as {rows, cols}.
+constexpr std::size_t SHAPES[][2] = {{1, 1}, {1, 7}, {7, 1}, {5, 9}, {40, 33}, {257, 130}};
+
+/// Thread counts passed to multiply(), including counts above the number of
+/// rows of most shapes. Zero uses one thread per hardware thread.
+constexpr std::size_t THREAD_COUNTS[] = {0, 1, 2, 3, 8, 64, 300};
+
+/// Sparsity patterns of the dense matrices tested.
+enum class Pattern {
+    /// About one entry in five is nonzero.
+    Scattered,
+    /// Scattered entries, with the first and last rows and columns empty.
+    EmptyEdges,
+    /// Every nonzero entry lies in the middle row.
+    OneRow,
+    /// No entry is nonzero.
+    Empty,
+};
+
+constexpr Pattern PATTERNS[] = {Pattern::Scattered, Pattern::EmptyEdges, Pattern::OneRow, Pattern::Empty};
+
+/**
+ * Returns the name of the given pattern for messages.
+ */
+const char* pattern_name(Pattern pattern)
+{
+    switch (pattern) {
+        case Pattern::Scattered:
+            return "scattered";
+        case Pattern::EmptyEdges:
+            return "empty-edges";
+        case Pattern::OneRow:
+            return "one-row";
+        case Pattern::Empty:
+            return "empty";
+    }
+    return "unknown";
+}
+
+/**
+ * Returns a dense matrix of the given dimensions whose nonzero entries
+ * follow the given pattern. Nonzero entries include negative values.
+ */
+template<typename T>
+Matrix<T> make_dense(std::size_t rows, std::size_t cols, Pattern pattern)
+{
+    Matrix<T> mat(rows, cols);
+    unsigned state{12345};
+    for (std::size_t row{0}; row < rows; ++row) {
+        for (std::size_t col{0}; col < cols; ++col) {
+            state = state * 1103515245u + 12345u;
+            const unsigned draw{(state >> 16u) % 100u};
+            bool nonzero{draw < 20};
+            switch (pattern) {
+                case Pattern::Scattered:
+                    break;
+                case Pattern::EmptyEdges:
+                    nonzero = nonzero && row != 0 && row + 1 != rows && col != 0 && col + 1 != cols;
+                    break;
+                case Pattern::OneRow:
+                    nonzero = row == rows / 2 && draw < 60;
+                    break;
+                case Pattern::Empty:
+                    nonzero = false;
+                    break;
+            }
+            mat(row, col) = nonzero ? static_cast<T>(static_cast<int>(draw % 19) - 9 + (draw % 19 == 9)) : T{};
+        }
+    }
+    return mat;
+}
+
+/**
+ * Returns `true` if the two matrices have the same dimensions and entries.
+ */
+template<typename T>
+bool equal_matrices(const Matrix<T>& a, const Matrix<T>& b)
+{
+    return a.rows() == b.rows() && a.cols() == b.cols() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+/**
+ * Returns `true` if the row offsets of the given matrix are nondecreasing
+ * and end at its nonzero count, and the column indices of every row are
+ * strictly increasing and in range.
+ */
+template<typename T>
+bool is_well_formed(const CsrMatrix<T>& mat)
+{
+    const auto& offsets = mat.row_offsets();
+    if (offsets.size() != mat.rows() + 1 || offsets.front() != 0 || offsets.back() != mat.nonzeros()
+        || !std::is_sorted(offsets.begin(), offsets.end())) {
+        return false;
+    }
+    const auto& cols = mat.col_indices();
+    for (std::size_t row{0}; row < mat.rows(); ++row) {
+        for (std::size_t i{offsets[row]}; i < offsets[row + 1]; ++i) {
+            if (cols[i] >= mat.cols() || (i > offsets[row] && cols[i] <= cols[i - 1])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks conversion, transpose, matrix-vector product and text round trip
+ * for every shape and pattern.
+ */
+template<typename T>
+void check_sparse(Checker& checker, const char* type)
+{
+    using Acc = MatrixAccumulator<T>;
+
+    for (const auto& shape : SHAPES) {
+        const std::size_t rows{shape[0]};
+        const std::size_t cols{shape[1]};
+        for (const Pattern pattern : PATTERNS) {
+            const char* const name{pattern_name(pattern)};
+            const Matrix<T> dense{make_dense<T>(rows, cols, pattern)};
+            const CsrMatrix<T> sparse(dense);
+
+            checker.check(
+                is_well_formed(sparse) && equal_matrices(sparse.to_dense(), dense),
+                "to_dense", type, name, "shape", rows, cols
+            );
+
+            Matrix<T> dense_t(0, 0);
+            dense.transpose_into(dense_t);
+            const CsrMatrix<T> sparse_t{sparse.transpose()};
+            checker.check(
+                sparse_t.rows() == cols && sparse_t.cols() == rows && is_well_formed(sparse_t)
+                && equal_matrices(sparse_t.to_dense(), dense_t),
+                "transpose", type, name, "shape", rows, cols
+            );
+
+            // The reference product accumulates every entry of a dense row,
+            // zeros included, in the accumulator type used by multiply().
+            std::vector<T> x(cols);
+            for (std::size_t i{0}; i < cols; ++i) {
+                x[i] = static_cast<T>(static_cast<int>(i % 7) - 3);
+            }
+            std::vector<T> expected(rows);
+            for (std::size_t row{0}; row < rows; ++row) {
+                Acc sum{};
+                for (std::size_t col{0}; col < cols; ++col) {
+                    sum += static_cast<Acc>(dense(row, col)) * static_cast<Acc>(x[col]);
+                }
+                expected[row] = static_cast<T>(sum);
+            }
+            for (const std::size_t threads : THREAD_COUNTS) {
+                // Fill y with a sentinel so that unwritten rows are caught.
+                std::vector<T> y(rows, static_cast<T>(77));
+                sparse.multiply(x.data(), y.data(), threads);
+                checker.check(y == expected, "multiply", type, name, "shape", rows, cols, "threads", threads);
+            }
+
+            std::stringstream text;
+            text << sparse;
+            CsrMatrix<T> read(rows, cols);
+            text >> read;
+            checker.check(
+                !text.fail() && is_well_formed(read) && equal_matrices(read.to_dense(), dense),
+                "text round trip", type, name, "shape", rows, cols
+            );
+        }
+    }
+}
+
+} // end namespace
+
+int main()
+{
+    Checker checker;
+
+    check_sparse<int>(checker, "int");
+    check_sparse<std::int8_t>(checker, "int8_t");
+    check_sparse<std::int64_t>(checker, "int64_t");
+    check_sparse<double>(checker, "double");
+
+    return checker.report();
+}
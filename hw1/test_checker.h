@@ -0,0 +1,72 @@
+/*
+ * ECEE 2160 Homework assignment 1 test helpers.
+ *
+ * Shared by the hw1 test programs. All members are defined in this header,
+ * so no implementation (.cpp) file is required.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_TEST_CHECKER_H
+#define ECEE_2160_HOMEWORK_TEST_CHECKER_H
+
+#include <cstddef>      // for std::size_t
+#include <iostream>     // for std::cout, std::cerr
+
+/**
+ * Counts checks and reports failures.
+ */
+class Checker {
+    std::size_t m_checks{0};
+    std::size_t m_failures{0};
+
+  public:
+    /**
+     * Records one check, printing the given description if it failed.
+     */
+    template<typename... Args>
+    void check(bool passed, const Args&... description)
+    {
+        ++m_checks;
+        if (!passed) {
+            ++m_failures;
+            std::cerr << "FAILED:";
+            ((std::cerr << ' ' << description), ...);
+            std::cerr << '\n';
+        }
+    }
+
+    /**
+     * Records one check that passes if the given function throws an
+     * exception of type E.
+     */
+    template<typename E, typename F, typename... Args>
+    void check_throws(F function, const Args&... description)
+    {
+        bool thrown{false};
+        try {
+            function();
+        } catch (const E&) {
+            thrown = true;
+        }
+        check(thrown, description...);
+    }
+
+    std::size_t checks() const { return m_checks; }
+
+    std::size_t failures() const { return m_failures; }
+
+    /**
+     * Prints the number of passed checks and returns the exit status of the
+     * test program.
+     */
+    int report() const
+    {
+        std::cout << m_checks - m_failures << " of " << m_checks << " checks passed\n";
+        return m_failures == 0 ? 0 : 1;
+    }
+};
+
+#endif //ECEE_2160_HOMEWORK_TEST_CHECKER_H
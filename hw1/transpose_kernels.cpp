@@ -0,0 +1,256 @@
+/*
+ * ECEE 2160 Homework assignment 1 SIMD transpose kernel definitions.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ * References
+ * ==========
+ *
+ *  - https://software.intel.com/sites/landingpage/IntrinsicsGuide/
+ *  - https://gcc.gnu.org/onlinedocs/gcc/x86-Built-in-Functions.html
+ *  - https://stackoverflow.com/questions/25622745/transpose-an-8x8-float-using-avx-avx2
+ *
+ */
+
+#include "transpose_kernels.h"
+
+#include <cstdint>      // for std::uint32_t
+#include <cstring>      // for std::memcpy
+#include <initializer_list> // for std::initializer_list
+
+// SIMD kernels are only compiled for x86 targets. Other targets, such as the
+// DE1-SoC, only receive the scalar kernel.
+#if defined(__x86_64__) || defined(__i386__)
+#define TRANSPOSE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace transpose_kernels {
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Width of the blocks handled by the scalar kernel.
+constexpr std::size_t SCALAR_WIDTH{4};
+
+/// Size of the entries moved by the kernels.
+constexpr std::size_t WORD{sizeof(std::uint32_t)};
+
+/**
+ * Portable swap-transpose kernel.
+ *
+ * Swapping entry (i, j) of the first block with entry (j, i) of the second
+ * block for every (i, j) is equivalent to the swap-transpose operation, with
+ * the exception that entries would be swapped twice when both blocks are the
+ * same. In that case, only the entries below the diagonal are swapped.
+ *
+ * Entries are copied with std::memcpy since the blocks may hold any 32-bit
+ * type. Compilers reduce each copy to a single load or store.
+ */
+void scalar_swap_transpose(void* a, void* b, std::size_t stride)
+{
+    const auto a_bytes = static_cast<unsigned char*>(a);
+    const auto b_bytes = static_cast<unsigned char*>(b);
+
+    for (std::size_t i{0}; i < SCALAR_WIDTH; ++i) {
+        const std::size_t j_end{a == b ? i : SCALAR_WIDTH};
+        for (std::size_t j{0}; j < j_end; ++j) {
+            unsigned char* const lhs{a_bytes + (i * stride + j) * WORD};
+            unsigned char* const rhs{b_bytes + (j * stride + i) * WORD};
+            std::uint32_t tmp;
+            std::memcpy(&tmp, lhs, WORD);
+            std::memcpy(lhs, rhs, WORD);
+            std::memcpy(rhs, &tmp, WORD);
+        }
+    }
+}
+
+#ifdef TRANSPOSE_KERNELS_X86
+
+/**
+ * Transposes a 4 by 4 block of 32-bit entries held in four SSE registers.
+ */
+__attribute__((target("sse2")))
+inline void transpose_4x4(__m128i& r0, __m128i& r1, __m128i& r2, __m128i& r3)
+{
+    // Interleave 32-bit entries of adjacent rows.
+    const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+    // Interleave 64-bit pairs to complete the columns.
+    r0 = _mm_unpacklo_epi64(t0, t1);
+    r1 = _mm_unpackhi_epi64(t0, t1);
+    r2 = _mm_unpacklo_epi64(t2, t3);
+    r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+/**
+ * SSE2 swap-transpose kernel for 4 by 4 blocks.
+ */
+__attribute__((target("sse2")))
+void sse2_swap_transpose(void* a, void* b, std::size_t stride)
+{
+    const auto row = [stride](void* base, std::size_t i) {
+        return reinterpret_cast<__m128i*>(static_cast<unsigned char*>(base) + i * stride * WORD);
+    };
+
+    __m128i a0 = _mm_loadu_si128(row(a, 0));
+    __m128i a1 = _mm_loadu_si128(row(a, 1));
+    __m128i a2 = _mm_loadu_si128(row(a, 2));
+    __m128i a3 = _mm_loadu_si128(row(a, 3));
+    __m128i b0 = _mm_loadu_si128(row(b, 0));
+    __m128i b1 = _mm_loadu_si128(row(b, 1));
+    __m128i b2 = _mm_loadu_si128(row(b, 2));
+    __m128i b3 = _mm_loadu_si128(row(b, 3));
+
+    transpose_4x4(a0, a1, a2, a3);
+    transpose_4x4(b0, b1, b2, b3);
+
+    _mm_storeu_si128(row(b, 0), a0);
+    _mm_storeu_si128(row(b, 1), a1);
+    _mm_storeu_si128(row(b, 2), a2);
+    _mm_storeu_si128(row(b, 3), a3);
+    _mm_storeu_si128(row(a, 0), b0);
+    _mm_storeu_si128(row(a, 1), b1);
+    _mm_storeu_si128(row(a, 2), b2);
+    _mm_storeu_si128(row(a, 3), b3);
+}
+
+/**
+ * Transposes an 8 by 8 block of 32-bit entries held in eight AVX registers.
+ */
+__attribute__((target("avx2")))
+inline void transpose_8x8(__m256i* r)
+{
+    // Interleave 32-bit entries of adjacent rows.
+    const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+    // Interleave 64-bit pairs, forming 4 by 4 transposes in each 128-bit lane.
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    // Exchange 128-bit lanes between the top and bottom halves of the block.
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/**
+ * AVX2 swap-transpose kernel for 8 by 8 blocks.
+ */
+__attribute__((target("avx2")))
+void avx2_swap_transpose(void* a, void* b, std::size_t stride)
+{
+    const auto row = [stride](void* base, std::size_t i) {
+        return reinterpret_cast<__m256i*>(static_cast<unsigned char*>(base) + i * stride * WORD);
+    };
+
+    __m256i a_rows[8];
+    __m256i b_rows[8];
+    for (std::size_t i{0}; i < 8; ++i) {
+        a_rows[i] = _mm256_loadu_si256(row(a, i));
+        b_rows[i] = _mm256_loadu_si256(row(b, i));
+    }
+
+    transpose_8x8(a_rows);
+    transpose_8x8(b_rows);
+
+    for (std::size_t i{0}; i < 8; ++i) {
+        _mm256_storeu_si256(row(b, i), a_rows[i]);
+        _mm256_storeu_si256(row(a, i), b_rows[i]);
+    }
+}
+
+#endif // TRANSPOSE_KERNELS_X86
+
+} // end namespace
+
+bool is_supported(KernelSet kernels)
+{
+    switch (kernels) {
+        case KernelSet::Scalar:
+            return true;
+#ifdef TRANSPOSE_KERNELS_X86
+        // __builtin_cpu_supports queries CPUID, including the check that the
+        // operating system saves the AVX register state.
+        case KernelSet::Sse2:
+            return __builtin_cpu_supports("sse2");
+        case KernelSet::Avx2:
+            return __builtin_cpu_supports("avx2");
+#else
+        case KernelSet::Sse2:
+        case KernelSet::Avx2:
+            return false;
+#endif
+    }
+    return false;
+}
+
+KernelSet best_kernel_set()
+{
+    // Function-local static is initialized exactly once, even when called
+    // from multiple threads.
+    static const KernelSet best = []() {
+        for (const auto kernels : {KernelSet::Avx2, KernelSet::Sse2}) {
+            if (is_supported(kernels)) {
+                return kernels;
+            }
+        }
+        return KernelSet::Scalar;
+    }();
+    return best;
+}
+
+std::size_t block_width(KernelSet kernels)
+{
+    switch (kernels) {
+        case KernelSet::Sse2:
+            return 4;
+        case KernelSet::Avx2:
+            return 8;
+        case KernelSet::Scalar:
+            break;
+    }
+    return SCALAR_WIDTH;
+}
+
+SwapTransposeFn swap_transpose_kernel(KernelSet kernels)
+{
+    switch (kernels) {
+#ifdef TRANSPOSE_KERNELS_X86
+        case KernelSet::Sse2:
+            return &sse2_swap_transpose;
+        case KernelSet::Avx2:
+            return &avx2_swap_transpose;
+#else
+        case KernelSet::Sse2:
+        case KernelSet::Avx2:
+#endif
+        case KernelSet::Scalar:
+            break;
+    }
+    return &scalar_swap_transpose;
+}
+
+} // end namespace transpose_kernels
@@ -0,0 +1,70 @@
+/*
+ * ECEE 2160 Homework assignment 1 SIMD transpose kernel declarations.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#ifndef ECEE_2160_HOMEWORK_TRANSPOSE_KERNELS_H
+#define ECEE_2160_HOMEWORK_TRANSPOSE_KERNELS_H
+
+#include <cstddef>      // for std::size_t
+
+namespace transpose_kernels {
+
+/**
+ * Families of transpose kernels, each targeting a different instruction set.
+ */
+enum class KernelSet {
+    /// Portable kernels that use plain loads and stores. Always available.
+    Scalar,
+    /// 4 by 4 kernels using SSE2 instructions.
+    Sse2,
+    /// 8 by 8 kernels using AVX2 instructions.
+    Avx2,
+};
+
+/**
+ * Signature of a block transpose kernel.
+ *
+ * A kernel reads the square block of 32-bit entries starting at `a` and the
+ * square block starting at `b`, then writes the transpose of the first block
+ * to `b` and the transpose of the second block to `a`. Consecutive rows of
+ * both blocks are `stride` entries apart. All reads occur before any writes,
+ * so passing the same block for `a` and `b` transposes it in-place.
+ *
+ * Entries are moved as raw 32-bit words, so the kernels apply to any
+ * trivially copyable entry type of that size, such as `int` and `float`.
+ */
+using SwapTransposeFn = void (*)(void* a, void* b, std::size_t stride);
+
+/**
+ * Returns `true` if the processor executing this program supports the
+ * given kernel set.
+ *
+ * Processor features are queried at runtime using CPUID.
+ */
+bool is_supported(KernelSet kernels);
+
+/**
+ * Returns the fastest kernel set supported by the processor executing this
+ * program. The processor is only queried on the first call.
+ */
+KernelSet best_kernel_set();
+
+/**
+ * Returns the width of the square blocks handled by the given kernel set.
+ */
+std::size_t block_width(KernelSet kernels);
+
+/**
+ * Returns the swap-transpose kernel belonging to the given kernel set.
+ *
+ * The caller is responsible for checking that the kernel set is supported.
+ */
+SwapTransposeFn swap_transpose_kernel(KernelSet kernels);
+
+} // end namespace transpose_kernels
+
+#endif //ECEE_2160_HOMEWORK_TRANSPOSE_KERNELS_H
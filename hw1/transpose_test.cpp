@@ -0,0 +1,285 @@
+/*
+ * ECEE 2160 Homework assignment 1 transpose kernel tests.
+ *
+ * Checks every SIMD transpose kernel set supported by the processor against
+ * index_transpose_square(). The kernels are forced one set at a time through
+ * the blocked and parallel transposes, over sizes that are odd or not
+ * multiples of the tile and block widths, and are also called directly to
+ * transpose single blocks in-place and to swap pairs of blocks.
+ *
+ * The transposes that pick their own kernels are checked entry by entry:
+ * recursive_transpose_square() over the same sizes, and cycle_transpose()
+ * and transpose_into() over every shape up to 39 by 39, plus a destination
+ * large enough for transpose_into() to use non-temporal stores.
+ *
+ * Failures are written to standard error, and the exit status is nonzero if
+ * any check fails.
+ *
+ * Usage: hw1-transpose-test
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-13
+ *
+ */
+
+#include "matrix.h"
+#include "test_checker.h"
+#include "transpose_kernels.h"
+
+#include <algorithm>    // for std::equal
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t, std::int64_t
+#include <iostream>     // for std::cout
+#include <stdexcept>    // for std::logic_error, std::invalid_argument
+#include <vector>       // for std::vector
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Matrix sizes tested. Includes sizes below, at, and just past the SIMD
+/// block widths and the default tile width.
+constexpr std::size_t SIZES[] = {
+    1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 64, 65, 100, 129, 255, 257,
+};
+
+/// Tile widths tested, including widths that are not multiples of the SIMD
+/// block widths.
+constexpr std::size_t TILE_SIZES[] = {1, 3, 4, 8, 12, 13, 32, Matrix<int>::DEFAULT_TILE_SIZE};
+
+/// Rows and columns of the rectangular shapes tested are all counts below
+/// this bound.
+constexpr std::size_t MAX_SHAPE_SIDE{40};
+
+/// Rows and columns of a matrix whose transpose_into() destination exceeds
+/// the non-temporal store threshold for entries of 4 bytes or more.
+constexpr std::size_t STREAMING_ROWS{1500};
+constexpr std::size_t STREAMING_COLS{1501};
+
+/// Thread counts tested with parallel_transpose_square().
+constexpr std::size_t THREAD_COUNTS[] = {1, 2, 3};
+
+/// The kernel sets, in the order they are tested.
+constexpr transpose_kernels::KernelSet KERNEL_SETS[] = {
+    transpose_kernels::KernelSet::Scalar,
+    transpose_kernels::KernelSet::Sse2,
+    transpose_kernels::KernelSet::Avx2,
+};
+
+/**
+ * Returns the name of the given kernel set for messages.
+ */
+const char* kernel_set_name(transpose_kernels::KernelSet kernels)
+{
+    switch (kernels) {
+        case transpose_kernels::KernelSet::Scalar:
+            return "scalar";
+        case transpose_kernels::KernelSet::Sse2:
+            return "sse2";
+        case transpose_kernels::KernelSet::Avx2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+/**
+ * Returns a matrix of the given dimensions with distinct entries.
+ */
+template<typename T>
+Matrix<T> make_matrix(std::size_t rows, std::size_t cols)
+{
+    Matrix<T> mat(rows, cols);
+    int value{0};
+    for (auto& elem : mat) {
+        elem = static_cast<T>(value++);
+    }
+    return mat;
+}
+
+/**
+ * Returns a square matrix of the given size with distinct entries.
+ */
+template<typename T>
+Matrix<T> make_matrix(std::size_t size)
+{
+    return make_matrix<T>(size, size);
+}
+
+/**
+ * Returns `true` if `result` is the transpose of `original`.
+ */
+template<typename T>
+bool is_transpose(const Matrix<T>& result, const Matrix<T>& original)
+{
+    if (result.rows() != original.cols() || result.cols() != original.rows()) {
+        return false;
+    }
+    for (std::size_t row{0}; row < original.rows(); ++row) {
+        for (std::size_t col{0}; col < original.cols(); ++col) {
+            if (result(col, row) != original(row, col)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks the blocked and parallel transposes with the given kernel set
+ * against index_transpose_square() for one entry type.
+ */
+template<typename T>
+void check_matrix_transposes(Checker& checker, transpose_kernels::KernelSet kernels, const char* type)
+{
+    for (const std::size_t size : SIZES) {
+        Matrix<T> expected{make_matrix<T>(size)};
+        expected.index_transpose_square();
+
+        for (const std::size_t tile_size : TILE_SIZES) {
+            Matrix<T> blocked{make_matrix<T>(size)};
+            blocked.blocked_transpose_square(tile_size, kernels);
+            checker.check(
+                std::equal(blocked.begin(), blocked.end(), expected.begin()),
+                "blocked_transpose_square", kernel_set_name(kernels), type,
+                "size", size, "tile", tile_size
+            );
+
+            for (const std::size_t threads : THREAD_COUNTS) {
+                Matrix<T> parallel{make_matrix<T>(size)};
+                parallel.parallel_transpose_square(threads, tile_size, kernels);
+                checker.check(
+                    std::equal(parallel.begin(), parallel.end(), expected.begin()),
+                    "parallel_transpose_square", kernel_set_name(kernels), type,
+                    "size", size, "tile", tile_size, "threads", threads
+                );
+            }
+        }
+    }
+}
+
+/**
+ * Calls the swap-transpose kernel of the given set directly, on a single
+ * block in-place and on a pair of distinct blocks, with row strides larger
+ * than the block width.
+ */
+void check_kernel(Checker& checker, transpose_kernels::KernelSet kernels)
+{
+    const auto kernel = transpose_kernels::swap_transpose_kernel(kernels);
+    const std::size_t width{transpose_kernels::block_width(kernels)};
+
+    for (const std::size_t stride : {width, width + 1, 2 * width + 3}) {
+        // The blocks at (0, 0) and (0, width) of a stride by stride grid,
+        // with a row of slack below so that both blocks fit.
+        std::vector<std::uint32_t> grid((width + 1) * stride + width);
+        for (std::size_t i{0}; i < grid.size(); ++i) {
+            grid[i] = static_cast<std::uint32_t>(i);
+        }
+        const std::vector<std::uint32_t> original{grid};
+        const auto at = [&](const std::vector<std::uint32_t>& values, std::size_t offset, std::size_t row, std::size_t col) {
+            return values[offset + row * stride + col];
+        };
+
+        // In-place transpose of the first block.
+        kernel(grid.data(), grid.data(), stride);
+        bool in_place_ok{true};
+        for (std::size_t row{0}; row < width; ++row) {
+            for (std::size_t col{0}; col < width; ++col) {
+                in_place_ok = in_place_ok && at(grid, 0, row, col) == at(original, 0, col, row);
+            }
+        }
+        checker.check(in_place_ok, "in-place kernel", kernel_set_name(kernels), "stride", stride);
+
+        // Swap-transpose of two distinct blocks, when the stride leaves room
+        // for a second block beside the first.
+        if (stride < 2 * width) {
+            continue;
+        }
+        grid = original;
+        kernel(grid.data(), grid.data() + width, stride);
+        bool swap_ok{true};
+        for (std::size_t row{0}; row < width; ++row) {
+            for (std::size_t col{0}; col < width; ++col) {
+                swap_ok = swap_ok
+                          && at(grid, width, row, col) == at(original, 0, col, row)
+                          && at(grid, 0, row, col) == at(original, width, col, row);
+            }
+        }
+        checker.check(swap_ok, "swap kernel", kernel_set_name(kernels), "stride", stride);
+    }
+}
+
+/**
+ * Checks the transposes that choose their own kernels against the entries
+ * of the original matrix for one entry type: recursive_transpose_square(),
+ * cycle_transpose() and transpose_into().
+ */
+template<typename T>
+void check_other_transposes(Checker& checker, const char* type)
+{
+    for (const std::size_t size : SIZES) {
+        const Matrix<T> original{make_matrix<T>(size)};
+        Matrix<T> recursive{make_matrix<T>(size)};
+        recursive.recursive_transpose_square();
+        checker.check(is_transpose(recursive, original), "recursive_transpose_square", type, "size", size);
+    }
+
+    for (std::size_t rows{0}; rows < MAX_SHAPE_SIDE; ++rows) {
+        for (std::size_t cols{0}; cols < MAX_SHAPE_SIDE; ++cols) {
+            const Matrix<T> original{make_matrix<T>(rows, cols)};
+
+            Matrix<T> cycled{make_matrix<T>(rows, cols)};
+            cycled.cycle_transpose();
+            checker.check(is_transpose(cycled, original), "cycle_transpose", type, "shape", rows, cols);
+
+            // A destination of the wrong shape is replaced, and one of the
+            // right shape is written in place.
+            Matrix<T> resized(1, 1);
+            original.transpose_into(resized);
+            checker.check(is_transpose(resized, original), "transpose_into resized", type, "shape", rows, cols);
+            Matrix<T> reused(cols, rows);
+            original.transpose_into(reused);
+            checker.check(is_transpose(reused, original), "transpose_into reused", type, "shape", rows, cols);
+        }
+    }
+
+    const Matrix<T> large{make_matrix<T>(STREAMING_ROWS, STREAMING_COLS)};
+    Matrix<T> streamed(0, 0);
+    large.transpose_into(streamed);
+    checker.check(is_transpose(streamed, large), "transpose_into streaming", type);
+
+    // Misuse is rejected rather than corrupting the matrix.
+    Matrix<T> rectangular{make_matrix<T>(2, 3)};
+    checker.check_throws<std::logic_error>(
+        [&] { rectangular.recursive_transpose_square(); },
+        "recursive_transpose_square accepted a rectangular matrix", type
+    );
+    checker.check_throws<std::invalid_argument>(
+        [&] { rectangular.transpose_into(rectangular); },
+        "transpose_into accepted itself as destination", type
+    );
+}
+
+} // end namespace
+
+int main()
+{
+    Checker checker;
+
+    for (const auto kernels : KERNEL_SETS) {
+        if (!transpose_kernels::is_supported(kernels)) {
+            std::cout << "skipping " << kernel_set_name(kernels) << ": not supported by this processor\n";
+            continue;
+        }
+        check_kernel(checker, kernels);
+        check_matrix_transposes<int>(checker, kernels, "int");
+        check_matrix_transposes<float>(checker, kernels, "float");
+        // Entries of other sizes take the scalar path regardless of the set.
+        check_matrix_transposes<double>(checker, kernels, "double");
+    }
+
+    check_other_transposes<int>(checker, "int");
+    check_other_transposes<float>(checker, "float");
+    check_other_transposes<double>(checker, "double");
+    check_other_transposes<std::int64_t>(checker, "int64_t");
+
+    return checker.report();
+}
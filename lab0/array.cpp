@@ -88,8 +88,9 @@ int main()
     std::cout << "Random integers from [" << RANDOM_MIN << ',' << RANDOM_MAX << "]:          ";
     print_iter(std::cout, random_array.begin(), random_array.end(), ", ");
 
-    // Sort the array of random integers.
-    selection_sort_array(random_array.data(), random_array.size());
+    // Sort the array of random integers. Small arrays are sorted on the
+    // calling thread, larger ones on all hardware threads.
+    parallel_sort_array(random_array.data(), random_array.size());
 
     // Print the sorted array to stdout.
     std::cout << "\nRandom integers from [" << RANDOM_MIN << ',' << RANDOM_MAX << "] (sorted): ";
@@ -13,15 +13,42 @@
  *  - http://www.cplusplus.com/reference/random/
  *  - http://www.cplusplus.com/reference/algorithm/
  *  - https://en.cppreference.com/w/cpp/named_req/ForwardIterator
+ *  - O. R. L. Peters, "Pattern-defeating quicksort," arXiv:2106.05123, 2021.
+ *  - D. R. Musser, "Introspective sorting and selection algorithms,"
+ *    Softw. Pract. Exper., vol. 27, no. 8, 1997.
+ *  - P. M. McIlroy, K. Bostic and M. D. McIlroy, "Engineering radix sort,"
+ *    Computing Systems, vol. 6, no. 1, 1993.
+ *  - M. Herf, "Radix tricks," 2001. (11-bit digits, one counting pass)
+ *  - J. L. Bentley and R. Sedgewick, "Fast algorithms for sorting and
+ *    searching strings," in Proc. SODA, 1997. (multikey quicksort)
+ *  - R. D. Blumofe and C. E. Leiserson, "Scheduling multithreaded
+ *    computations by work stealing," J. ACM, vol. 46, no. 5, 1999.
+ *  - T. H. Cormen et al., Introduction to Algorithms, 3rd ed., ch. 27.3,
+ *    "Multithreaded merge sort."
  */
 
 #ifndef ECEE_2160_LAB_REPORTS_LAB0_UTILS_H
 #define ECEE_2160_LAB_REPORTS_LAB0_UTILS_H
 
+#include <algorithm>        // for std::iter_swap, std::make_heap, std::merge, ...
+#include <atomic>           // for std::atomic
+#include <climits>          // for CHAR_BIT
+#include <cstddef>          // for std::size_t
+#include <cstdint>          // for std::uint64_t
+#include <deque>            // for std::deque
+#include <exception>        // for std::exception_ptr, std::rethrow_exception, ...
+#include <functional>       // for std::less, std::function
 #include <iostream>         // for std::ostream - we can't use iosfwd since this
                             // header includes definitions that write to ostream.
+#include <iterator>         // for std::make_move_iterator, std::begin, std::end
+#include <memory>           // for std::unique_ptr, std::make_unique
+#include <mutex>            // for std::mutex, std::lock_guard
+#include <string>           // for std::string
 #include <string_view>      // for std::string_view
-#include <utility>          // for std::swap
+#include <thread>           // for std::thread, std::this_thread::yield
+#include <type_traits>      // for std::is_integral_v, std::make_unsigned_t, ...
+#include <utility>          // for std::swap, std::move, std::pair
+#include <vector>           // for std::vector
 
 /**
  * Prints the elements of the given forward iterator to the given output
@@ -65,9 +92,8 @@ void print_iter(std::ostream& out, I iter, I end, const std::string_view delim)
  * Sorts the given array of consecutive elements.
  *
  * This function implements the selection sort algorithm per the lab assignment
- * instructions, which occurs in O(1) space and O(n^2) time.
- *
- * This function is used in lab assignments 0.2 and 0.3.
+ * instructions, which occurs in O(1) space and O(n^2) time. Use sort_array()
+ * for anything but small arrays.
  *
  * @tparam T Array content type.
  * @param values Mutable pointer to array contents.
@@ -77,14 +103,13 @@ template<class T>
 void selection_sort_array(T* values, std::size_t size)
 {
     for (std::size_t i{0}; i < size; ++i) {
-        // Store both the value and index of the  minimum unsorted element.
-        T min_element{values[i]};
+        // Store only the index of the minimum unsorted element, so that no
+        // element is copied while searching.
         std::size_t min_index{i};
 
         // Locate the index of the minimum element in the unsorted porition.
         for (std::size_t j{i + 1}; j < size; ++j) {
-            if (values[j] < min_element) {
-                min_element = values[j];
+            if (values[j] < values[min_index]) {
                 min_index = j;
             }
         }
@@ -94,4 +119,1129 @@ void selection_sort_array(T* values, std::size_t size)
     }
 }
 
+namespace sort_detail {
+
+/// Ranges shorter than this are sorted by insertion sort.
+constexpr std::size_t INSERTION_SORT_THRESHOLD{24};
+
+/// Ranges longer than this choose their pivot with Tukey's ninther instead
+/// of the median of three.
+constexpr std::size_t NINTHER_THRESHOLD{128};
+
+/// Number of element moves after which partial_insertion_sort() gives up.
+constexpr std::size_t PARTIAL_INSERTION_SORT_LIMIT{8};
+
+/**
+ * Sorts the given range by insertion sort, moving elements.
+ */
+template<class T, class C>
+void insertion_sort(T* begin, T* end, C comp)
+{
+    if (begin == end) {
+        return;
+    }
+
+    for (T* cur{begin + 1}; cur != end; ++cur) {
+        T* sift{cur};
+        T* sift_1{cur - 1};
+
+        // Only elements out of order are lifted out of the array.
+        if (comp(*sift, *sift_1)) {
+            T tmp{std::move(*sift)};
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+/**
+ * Sorts the given range by insertion sort, assuming that the element just
+ * before the range is no greater than any element in it. The assumption
+ * removes the bounds check from the inner loop.
+ */
+template<class T, class C>
+void unguarded_insertion_sort(T* begin, T* end, C comp)
+{
+    if (begin == end) {
+        return;
+    }
+
+    for (T* cur{begin + 1}; cur != end; ++cur) {
+        T* sift{cur};
+        T* sift_1{cur - 1};
+
+        if (comp(*sift, *sift_1)) {
+            T tmp{std::move(*sift)};
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+/**
+ * Attempts to sort the given range by insertion sort, giving up once more
+ * than PARTIAL_INSERTION_SORT_LIMIT elements have been moved.
+ *
+ * @return `true` if the range was sorted.
+ */
+template<class T, class C>
+bool partial_insertion_sort(T* begin, T* end, C comp)
+{
+    if (begin == end) {
+        return true;
+    }
+
+    std::size_t moves{0};
+    for (T* cur{begin + 1}; cur != end; ++cur) {
+        T* sift{cur};
+        T* sift_1{cur - 1};
+
+        if (comp(*sift, *sift_1)) {
+            T tmp{std::move(*sift)};
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+            moves += static_cast<std::size_t>(cur - sift);
+        }
+
+        if (moves > PARTIAL_INSERTION_SORT_LIMIT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Sorts the two given elements.
+ */
+template<class T, class C>
+void sort2(T* a, T* b, C comp)
+{
+    if (comp(*b, *a)) {
+        std::iter_swap(a, b);
+    }
+}
+
+/**
+ * Sorts the three given elements.
+ */
+template<class T, class C>
+void sort3(T* a, T* b, T* c, C comp)
+{
+    sort2(a, b, comp);
+    sort2(b, c, comp);
+    sort2(a, b, comp);
+}
+
+/**
+ * Partitions the given range around its first element, the pivot. Elements
+ * equal to the pivot go to the right partition.
+ *
+ * The range must contain an element no less than the pivot after the
+ * pivot, which the pivot selection guarantees.
+ *
+ * @return The final position of the pivot, and `true` if no elements had
+ *         to be swapped.
+ */
+template<class T, class C>
+std::pair<T*, bool> partition_right(T* begin, T* end, C comp)
+{
+    T pivot{std::move(*begin)};
+    T* first{begin};
+    T* last{end};
+
+    // Find the first element no less than the pivot. The median of three
+    // guarantees that one exists.
+    while (comp(*++first, pivot)) {}
+
+    // Find the last element less than the pivot. If there was no element
+    // before `first` to stop the search, it must be bounded explicitly.
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {}
+    } else {
+        while (!comp(*--last, pivot)) {}
+    }
+
+    // If the first pair of misplaced elements crosses, the range was
+    // already partitioned.
+    const bool already_partitioned{first >= last};
+
+    // Swap misplaced pairs. The elements found above act as sentinels, so
+    // the inner loops need no bounds checks.
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(*++first, pivot)) {}
+        while (!comp(*--last, pivot)) {}
+    }
+
+    // Move the pivot into its final position.
+    T* const pivot_pos{first - 1};
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+
+    return {pivot_pos, already_partitioned};
+}
+
+/**
+ * Partitions the given range around its first element, the pivot, putting
+ * elements equal to the pivot in the left partition.
+ *
+ * This is used when the pivot equals the element just before the range, in
+ * which case every element of the left partition equals the pivot and needs
+ * no further sorting. Inputs with many duplicates are thus sorted in linear
+ * time.
+ *
+ * @return The final position of the pivot.
+ */
+template<class T, class C>
+T* partition_left(T* begin, T* end, C comp)
+{
+    T pivot{std::move(*begin)};
+    T* first{begin};
+    T* last{end};
+
+    while (comp(pivot, *--last)) {}
+
+    if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first)) {}
+    } else {
+        while (!comp(pivot, *++first)) {}
+    }
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last)) {}
+        while (!comp(pivot, *++first)) {}
+    }
+
+    T* const pivot_pos{last};
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+
+    return pivot_pos;
+}
+
+/**
+ * Sorts the given range by pattern-defeating quicksort.
+ *
+ * @param bad_allowed Number of highly unbalanced partitions allowed before
+ *                    switching to heapsort.
+ * @param leftmost `true` if the range is at the start of the whole array,
+ *                 so that there is no element before it.
+ */
+template<class T, class C>
+void pdqsort_loop(T* begin, T* end, C comp, std::size_t bad_allowed, bool leftmost)
+{
+    // Iterate on the right partition and recurse on the left one.
+    while (true) {
+        const auto size = static_cast<std::size_t>(end - begin);
+
+        // Short ranges are faster to sort by insertion sort.
+        if (size < INSERTION_SORT_THRESHOLD) {
+            if (leftmost) {
+                insertion_sort(begin, end, comp);
+            } else {
+                unguarded_insertion_sort(begin, end, comp);
+            }
+            return;
+        }
+
+        // Choose the pivot as the median of three, or as the ninther for long
+        // ranges, and move it to the start of the range.
+        const std::size_t half{size / 2};
+        if (size > NINTHER_THRESHOLD) {
+            sort3(begin, begin + half, end - 1, comp);
+            sort3(begin + 1, begin + (half - 1), end - 2, comp);
+            sort3(begin + 2, begin + (half + 1), end - 3, comp);
+            sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+            std::iter_swap(begin, begin + half);
+        } else {
+            sort3(begin + half, begin, end - 1, comp);
+        }
+
+        // If the pivot equals the element before the range, which is the
+        // pivot of an enclosing partition, every element equal to it belongs
+        // in the left partition and is already in place.
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        const auto partition = partition_right(begin, end, comp);
+        T* const pivot_pos{partition.first};
+        const bool already_partitioned{partition.second};
+
+        const auto left_size = static_cast<std::size_t>(pivot_pos - begin);
+        const auto right_size = static_cast<std::size_t>(end - (pivot_pos + 1));
+        const bool highly_unbalanced{left_size < size / 8 || right_size < size / 8};
+
+        if (highly_unbalanced) {
+            // Too many bad partitions mean quicksort is heading for quadratic
+            // time, so guarantee O(n log n) with heapsort.
+            if (--bad_allowed == 0) {
+                std::make_heap(begin, end, comp);
+                std::sort_heap(begin, end, comp);
+                return;
+            }
+
+            // Swap a few elements into new positions to break up patterns
+            // that cause bad pivots.
+            if (left_size >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(begin, begin + left_size / 4);
+                std::iter_swap(pivot_pos - 1, pivot_pos - left_size / 4);
+
+                if (left_size > NINTHER_THRESHOLD) {
+                    std::iter_swap(begin + 1, begin + (left_size / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (left_size / 4 + 2));
+                    std::iter_swap(pivot_pos - 2, pivot_pos - (left_size / 4 + 1));
+                    std::iter_swap(pivot_pos - 3, pivot_pos - (left_size / 4 + 2));
+                }
+            }
+
+            if (right_size >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(pivot_pos + 1, pivot_pos + (1 + right_size / 4));
+                std::iter_swap(end - 1, end - right_size / 4);
+
+                if (right_size > NINTHER_THRESHOLD) {
+                    std::iter_swap(pivot_pos + 2, pivot_pos + (2 + right_size / 4));
+                    std::iter_swap(pivot_pos + 3, pivot_pos + (3 + right_size / 4));
+                    std::iter_swap(end - 2, end - (1 + right_size / 4));
+                    std::iter_swap(end - 3, end - (2 + right_size / 4));
+                }
+            }
+        } else if (already_partitioned
+                   && partial_insertion_sort(begin, pivot_pos, comp)
+                   && partial_insertion_sort(pivot_pos + 1, end, comp)) {
+            // A range that needed no swaps is likely sorted already. If a
+            // cheap insertion sort confirms it, both partitions are done.
+            return;
+        }
+
+        pdqsort_loop(begin, pivot_pos, comp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+/**
+ * Returns the number of highly unbalanced partitions allowed when sorting a
+ * range of the given size by quicksort, about log2(size).
+ */
+inline std::size_t bad_partition_budget(std::size_t size)
+{
+    std::size_t bad_allowed{1};
+    for (std::size_t remaining{size}; remaining > 1; remaining >>= 1u) {
+        ++bad_allowed;
+    }
+    return bad_allowed;
+}
+
+/// Smallest array that sort_array() sorts by radix sort. Below this, the
+/// cost of clearing and scanning the digit counts outweighs the savings.
+constexpr std::size_t RADIX_SORT_THRESHOLD{1024};
+
+/**
+ * Whether sort_array() sorts arrays of T ordered by C with radix sort.
+ *
+ * Radix sort applies to integers of 8, 16, 32 or 64 bits in ascending
+ * order. Other comparisons may order integers arbitrarily, so they fall back
+ * on quicksort.
+ */
+template<class T, class C>
+constexpr bool RADIX_SORTABLE{
+    std::is_integral_v<T>
+    && !std::is_same_v<T, bool>
+    && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+    && (std::is_same_v<C, std::less<>> || std::is_same_v<C, std::less<T>>)
+};
+
+/**
+ * Sorts the given array of integers by least significant digit radix sort.
+ *
+ * 8- and 16-bit integers are sorted by 8-bit digits, and wider integers by
+ * 11-bit digits, so that 32-bit integers take 3 passes and 64-bit integers
+ * take 6. The counts of every digit are gathered in a single pass over the
+ * array before any elements move. A digit that has the same value in every
+ * element would leave the order unchanged, so its pass is skipped. Each pass
+ * scatters the elements between the array and one scratch buffer.
+ *
+ * Signed integers are sorted by flipping their sign bit, which maps them
+ * onto unsigned integers of the same order.
+ */
+template<class T>
+void radix_sort(T* values, std::size_t size)
+{
+    using Key = std::make_unsigned_t<T>;
+
+    constexpr unsigned KEY_BITS{sizeof(T) * CHAR_BIT};
+    constexpr unsigned DIGIT_BITS{KEY_BITS <= 16 ? 8u : 11u};
+    constexpr unsigned PASSES{(KEY_BITS + DIGIT_BITS - 1) / DIGIT_BITS};
+    constexpr std::size_t RADIX{std::size_t{1} << DIGIT_BITS};
+    constexpr Key DIGIT_MASK{static_cast<Key>(RADIX - 1)};
+    constexpr Key SIGN_FLIP{std::is_signed_v<T> ? static_cast<Key>(Key{1} << (KEY_BITS - 1)) : Key{0}};
+
+    // Arrays of fewer than two elements are already sorted, and the pass
+    // skipping below reads the first element.
+    if (size < 2) {
+        return;
+    }
+
+    const auto key_of = [](T value) {
+        return static_cast<Key>(static_cast<Key>(value) ^ SIGN_FLIP);
+    };
+
+    // Count every digit of every element in one pass.
+    std::vector<std::size_t> counts(PASSES * RADIX);
+    for (std::size_t i{0}; i < size; ++i) {
+        const Key key{key_of(values[i])};
+        for (unsigned pass{0}; pass < PASSES; ++pass) {
+            ++counts[pass * RADIX + ((key >> (pass * DIGIT_BITS)) & DIGIT_MASK)];
+        }
+    }
+
+    std::unique_ptr<T[]> buffer{new T[size]};
+    T* source{values};
+    T* destination{buffer.get()};
+
+    for (unsigned pass{0}; pass < PASSES; ++pass) {
+        std::size_t* const pass_counts{counts.data() + pass * RADIX};
+        const unsigned shift{pass * DIGIT_BITS};
+
+        // Skip the pass if every element has the same digit.
+        if (pass_counts[(key_of(source[0]) >> shift) & DIGIT_MASK] == size) {
+            continue;
+        }
+
+        // Turn the counts into the position of the first element with each
+        // digit.
+        std::size_t position{0};
+        for (std::size_t digit{0}; digit < RADIX; ++digit) {
+            const std::size_t count{pass_counts[digit]};
+            pass_counts[digit] = position;
+            position += count;
+        }
+
+        for (std::size_t i{0}; i < size; ++i) {
+            const T value{source[i]};
+            destination[pass_counts[(key_of(value) >> shift) & DIGIT_MASK]++] = value;
+        }
+        std::swap(source, destination);
+    }
+
+    // After an odd number of passes the sorted elements are in the buffer.
+    if (source != values) {
+        std::copy(source, source + size, values);
+    }
+}
+
+/// Smallest array that sort_array() sorts by multikey quicksort.
+constexpr std::size_t STRING_SORT_THRESHOLD{64};
+
+/// Ranges of at most this many strings are finished by insertion sort on
+/// their remaining characters.
+constexpr std::size_t MULTIKEY_INSERTION_THRESHOLD{16};
+
+/**
+ * Whether sort_array() sorts arrays of T ordered by C with multikey
+ * quicksort.
+ */
+template<class T, class C>
+constexpr bool STRING_SORTABLE{
+    std::is_same_v<T, std::string>
+    && (std::is_same_v<C, std::less<>> || std::is_same_v<C, std::less<T>>)
+};
+
+/// Number of characters compared at once by multikey_quicksort().
+constexpr std::size_t KEY_CHARS{8};
+
+/**
+ * A handle to a string being sorted by string_sort().
+ *
+ * Besides the string's characters and length, a handle caches the next
+ * KEY_CHARS characters to be compared as one integer, so that partitioning
+ * reads the handles in order and rarely touches the strings themselves.
+ */
+struct StringHandle {
+    /// Characters at the current depth, the first in the most significant
+    /// byte, padded with zero bytes past the end of the string.
+    std::uint64_t key;
+    const char* data;
+    std::size_t size;
+    /// Position of the string in the array being sorted.
+    std::size_t index;
+};
+
+/**
+ * Returns the KEY_CHARS characters of the given string starting at the given
+ * position as an integer, the first in the most significant byte, padded
+ * with zero bytes past the end of the string.
+ *
+ * Keys order like the characters they hold, so strings whose keys differ
+ * order like their keys.
+ */
+inline std::uint64_t string_key(const char* data, std::size_t size, std::size_t depth)
+{
+    std::uint64_t key{0};
+    if (size >= depth + KEY_CHARS) {
+        for (std::size_t i{0}; i < KEY_CHARS; ++i) {
+            key = (key << CHAR_BIT) | static_cast<unsigned char>(data[depth + i]);
+        }
+    } else {
+        for (std::size_t i{depth}; i < depth + KEY_CHARS; ++i) {
+            const auto ch = i < size ? static_cast<unsigned char>(data[i]) : 0u;
+            key = (key << CHAR_BIT) | ch;
+        }
+    }
+    return key;
+}
+
+/**
+ * Sets the key of the given handle to the characters starting at the given
+ * position.
+ */
+inline void load_key(StringHandle& string, std::size_t depth)
+{
+    string.key = string_key(string.data, string.size, depth);
+}
+
+/**
+ * Returns `true` if the first string orders before the second, given that
+ * they share their first `depth` characters and their keys are loaded at
+ * that depth.
+ */
+inline bool suffix_less(const StringHandle& a, const StringHandle& b, std::size_t depth)
+{
+    if (a.key != b.key) {
+        return a.key < b.key;
+    }
+    return std::string_view(a.data + depth, a.size - depth)
+           < std::string_view(b.data + depth, b.size - depth);
+}
+
+/**
+ * Returns the median of the three given keys.
+ */
+inline std::uint64_t median_key(std::uint64_t a, std::uint64_t b, std::uint64_t c)
+{
+    if (a > c) {
+        std::swap(a, c);
+    }
+    return std::min(std::max(b, a), c);
+}
+
+/**
+ * Sorts the given range of string handles by multikey quicksort, given that
+ * the strings agree on their first `depth` characters and their keys are
+ * loaded at that depth.
+ *
+ * Each step partitions the range three ways by key, that is, by the next
+ * KEY_CHARS characters. Strings with a smaller or larger key are sorted
+ * at the same depth, and strings with the same key move on to the next
+ * KEY_CHARS characters, so every character of a shared prefix is loaded
+ * once per string. Of the three parts, the two shorter ones are sorted
+ * recursively and the longest is sorted by the next step, so the recursion
+ * is at most log2(size) calls deep.
+ *
+ * Keys are padded with zero bytes, so strings with equal keys that end
+ * within the key are not told apart by it. Each such string is a prefix of
+ * all longer strings of the range with the same key, followed by zero
+ * bytes, so these strings order first, by length.
+ *
+ * Like in pdqsort_loop(), pivots are the median of three keys, or of nine
+ * for long ranges, and after `bad_allowed` partitions that leave almost all
+ * strings on one side of the pivot, the range is finished by
+ * pattern-defeating quicksort on the remaining characters.
+ */
+inline void multikey_quicksort(StringHandle* begin, std::size_t size, std::size_t depth, std::size_t bad_allowed)
+{
+    while (size > MULTIKEY_INSERTION_THRESHOLD) {
+        // Choose the pivot key as the median of three, or as the ninther of
+        // keys spread over long ranges.
+        std::uint64_t pivot;
+        if (size > NINTHER_THRESHOLD) {
+            const std::size_t step{size / 8};
+            pivot = median_key(
+                median_key(begin[0].key, begin[step].key, begin[2 * step].key),
+                median_key(begin[3 * step].key, begin[4 * step].key, begin[5 * step].key),
+                median_key(begin[6 * step].key, begin[7 * step].key, begin[size - 1].key)
+            );
+        } else {
+            pivot = median_key(begin[0].key, begin[size / 2].key, begin[size - 1].key);
+        }
+
+        // Partition into [0, lt) below, [lt, gt) equal to and [gt, size)
+        // above the pivot key.
+        std::size_t lt{0};
+        std::size_t i{0};
+        std::size_t gt{size};
+        while (i < gt) {
+            const std::uint64_t key{begin[i].key};
+            if (key < pivot) {
+                std::swap(begin[lt++], begin[i++]);
+            } else if (key > pivot) {
+                std::swap(begin[i], begin[--gt]);
+            } else {
+                ++i;
+            }
+        }
+
+        // Too many partitions with a pivot near either end of the keys mean
+        // quicksort is heading for quadratic time, so finish the range with
+        // pdqsort, which guarantees O(n log n) comparisons.
+        if (std::max(lt, size - gt) > size - size / 8 && --bad_allowed == 0) {
+            pdqsort_loop(
+                begin, begin + size,
+                [depth](const StringHandle& a, const StringHandle& b) { return suffix_less(a, b, depth); },
+                bad_partition_budget(size),
+                true
+            );
+            return;
+        }
+
+        // Order the strings that end within the key by length, ahead of the
+        // rest.
+        StringHandle* const equal_end{begin + gt};
+        StringHandle* const ended{std::partition(begin + lt, equal_end, [&](const StringHandle& string) {
+            return string.size < depth + KEY_CHARS;
+        })};
+        std::sort(begin + lt, ended, [](const StringHandle& a, const StringHandle& b) {
+            return a.size < b.size;
+        });
+
+        // The strings that share the key and go on past it continue with the
+        // next characters.
+        for (StringHandle* string{ended}; string != equal_end; ++string) {
+            load_key(*string, depth + KEY_CHARS);
+        }
+
+        struct Part {
+            StringHandle* begin;
+            std::size_t size;
+            std::size_t depth;
+        };
+        const Part parts[]{
+            {begin, lt, depth},
+            {ended, static_cast<std::size_t>(equal_end - ended), depth + KEY_CHARS},
+            {equal_end, size - gt, depth},
+        };
+        const Part* const longest{std::max_element(
+            std::begin(parts), std::end(parts),
+            [](const Part& a, const Part& b) { return a.size < b.size; }
+        )};
+        for (const Part& part : parts) {
+            if (&part != longest) {
+                multikey_quicksort(part.begin, part.size, part.depth, bad_allowed);
+            }
+        }
+        begin = longest->begin;
+        size = longest->size;
+        depth = longest->depth;
+    }
+
+    // Short ranges are faster to finish by comparing the remaining
+    // characters directly.
+    for (std::size_t i{1}; i < size; ++i) {
+        const StringHandle string{begin[i]};
+        std::size_t j{i};
+        for (; j > 0 && suffix_less(string, begin[j - 1], depth); --j) {
+            begin[j] = begin[j - 1];
+        }
+        begin[j] = string;
+    }
+}
+
+/**
+ * Sorts the given array of strings by multikey quicksort.
+ *
+ * The sort works on an array of handles to the strings, so partitioning
+ * moves small handles rather than string objects. Once the handles are
+ * sorted, the strings are moved into place by following the cycles of the
+ * permutation, which moves each string at most once more than needed.
+ */
+inline void string_sort(std::string* values, std::size_t size)
+{
+    std::vector<StringHandle> handles(size);
+    for (std::size_t i{0}; i < size; ++i) {
+        handles[i] = StringHandle{0, values[i].data(), values[i].size(), i};
+        load_key(handles[i], 0);
+    }
+
+    multikey_quicksort(handles.data(), size, 0, bad_partition_budget(size));
+
+    // handles[i] now names the string that belongs at position i.
+    for (std::size_t i{0}; i < size; ++i) {
+        if (handles[i].index == i) {
+            continue;
+        }
+        std::string displaced{std::move(values[i])};
+        std::size_t j{i};
+        while (true) {
+            const std::size_t source{handles[j].index};
+            handles[j].index = j;
+            if (source == i) {
+                values[j] = std::move(displaced);
+                break;
+            }
+            values[j] = std::move(values[source]);
+            j = source;
+        }
+    }
+}
+
+} // end namespace sort_detail
+
+/**
+ * Sorts the given array of consecutive elements in O(n log n) time.
+ *
+ * This function implements pattern-defeating quicksort, a hybrid of
+ * quicksort, insertion sort and heapsort:
+ *
+ *  - Ranges shorter than 24 elements are sorted by insertion sort.
+ *  - Pivots are the median of three elements, or of nine elements for long
+ *    ranges.
+ *  - A partition that needed no swaps is checked with a bounded insertion
+ *    sort, so sorted and nearly sorted inputs take linear time.
+ *  - Runs of elements equal to an earlier pivot are set aside in one pass,
+ *    so inputs with few distinct values take linear time.
+ *  - Highly unbalanced partitions cause a few elements to be shuffled, and
+ *    after log2(n) of them the range is finished by heapsort.
+ *
+ * Pattern-defeating quicksort only ever moves or swaps elements, never
+ * copies them, and allocates no memory. The sort is not stable.
+ *
+ * Arrays of at least 1024 integers sorted in ascending order are instead
+ * sorted by radix sort in O(n) time, using a scratch buffer of the same
+ * size as the array. Arrays of at least 64 std::strings sorted in ascending
+ * order are sorted by multikey quicksort on an array of handles to the
+ * strings, which compares strings eight characters at a time from a cache
+ * in each handle instead of comparing whole strings, so long shared
+ * prefixes are scanned once rather than in every comparison. Both allocate
+ * their buffers, and may throw std::bad_alloc. These choices are made at
+ * compile time from the element and comparison types.
+ *
+ * This function is used in lab assignments 0.2 and 0.3.
+ *
+ * @tparam T Array content type.
+ * @tparam C Comparison function type.
+ * @param values Mutable pointer to array contents.
+ * @param size Array length.
+ * @param comp Strict weak ordering of the elements.
+ */
+template<class T, class C = std::less<>>
+void sort_array(T* values, std::size_t size, C comp = C{})
+{
+    if constexpr (sort_detail::RADIX_SORTABLE<T, C>) {
+        if (size >= sort_detail::RADIX_SORT_THRESHOLD) {
+            sort_detail::radix_sort(values, size);
+            return;
+        }
+    } else if constexpr (sort_detail::STRING_SORTABLE<T, C>) {
+        if (size >= sort_detail::STRING_SORT_THRESHOLD) {
+            sort_detail::string_sort(values, size);
+            return;
+        }
+    }
+
+    sort_detail::pdqsort_loop(values, values + size, comp, sort_detail::bad_partition_budget(size), true);
+}
+
+namespace sort_detail {
+
+/// Smallest number of elements sorted by one task of parallel_sort_array().
+constexpr std::size_t PARALLEL_SORT_GRAIN{std::size_t{1} << 14u};
+
+/// Smallest number of elements merged by one task of parallel_sort_array().
+constexpr std::size_t PARALLEL_MERGE_GRAIN{std::size_t{1} << 14u};
+
+/// Number of leaf tasks per thread that parallel_sort_array() aims for, so
+/// that idle threads have work to steal when some chunks sort slower.
+constexpr std::size_t TASKS_PER_THREAD{8};
+
+/**
+ * A fixed set of threads that run fork-join tasks by work stealing.
+ *
+ * Each thread owns a deque of tasks. A thread pushes the tasks it spawns on
+ * the back of its own deque and takes work from the back, which is the most
+ * recently spawned and smallest task. When its deque is empty, it steals
+ * from the front of another thread's deque, taking the oldest and largest
+ * task. The thread that creates the pool takes part as worker 0.
+ *
+ * Tasks receive the index of the worker running them, which they pass back
+ * to spawn() and wait().
+ *
+ * An exception thrown by a task is caught on the thread that ran it and
+ * stored in the task's group. wait() rethrows it once every task of the
+ * group has finished, so no task outlives the frame that spawned it.
+ */
+class WorkStealingPool {
+  public:
+    /// A task, called with the index of the worker running it.
+    using Task = std::function<void(std::size_t)>;
+
+    /**
+     * Tracks the completion of a set of spawned tasks.
+     */
+    struct TaskGroup {
+        std::atomic<std::size_t> pending{0};
+        /// Guards `error`.
+        std::mutex mutex;
+        /// First exception thrown by a task of the group.
+        std::exception_ptr error;
+
+        /**
+         * Stores the exception being handled, unless one is already stored.
+         */
+        void capture()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+  private:
+    /// Task deque of one worker.
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /// Task deques, one per worker.
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+
+    /// Threads of workers 1 and up.
+    std::vector<std::thread> m_threads;
+
+    /// Set when the pool is being destroyed.
+    std::atomic<bool> m_stopping{false};
+
+    /**
+     * Takes a task from the given worker's deque, or steals one from
+     * another worker, and runs it.
+     *
+     * @return `false` if no task was found.
+     */
+    bool run_one(std::size_t worker)
+    {
+        Task task;
+        {
+            WorkerQueue& own{*m_queues[worker]};
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+            }
+        }
+
+        // Visit the other workers starting with the next one, so that thieves
+        // spread out over their victims.
+        for (std::size_t i{1}; !task && i < m_queues.size(); ++i) {
+            WorkerQueue& victim{*m_queues[(worker + i) % m_queues.size()]};
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+
+        if (!task) {
+            return false;
+        }
+        task(worker);
+        return true;
+    }
+
+  public:
+    /**
+     * Starts a pool with the given number of workers, including the calling
+     * thread.
+     *
+     * @throws std::system_error if a thread cannot be started, after the
+     *         threads already started have been stopped.
+     */
+    explicit WorkStealingPool(std::size_t worker_count)
+    {
+        m_queues.reserve(worker_count);
+        for (std::size_t i{0}; i < worker_count; ++i) {
+            m_queues.push_back(std::make_unique<WorkerQueue>());
+        }
+
+        m_threads.reserve(worker_count - 1);
+        try {
+            for (std::size_t i{1}; i < worker_count; ++i) {
+                m_threads.emplace_back([this, i] {
+                    while (!m_stopping.load(std::memory_order_acquire)) {
+                        if (!run_one(i)) {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+        } catch (...) {
+            // The destructor does not run when the constructor throws, so
+            // stop and join the threads already started here. Otherwise the
+            // joinable threads would call std::terminate on destruction.
+            m_stopping.store(true, std::memory_order_release);
+            for (auto& thread : m_threads) {
+                thread.join();
+            }
+            throw;
+        }
+    }
+
+    ~WorkStealingPool()
+    {
+        m_stopping.store(true, std::memory_order_release);
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * Returns the number of workers, including the thread that created the
+     * pool.
+     */
+    std::size_t size() const { return m_queues.size(); }
+
+    /**
+     * Queues the given task on the given worker's deque as a member of the
+     * given group.
+     */
+    void spawn(std::size_t worker, TaskGroup& group, Task task)
+    {
+        Task wrapped{[&group, task = std::move(task)](std::size_t runner) {
+            try {
+                task(runner);
+            } catch (...) {
+                group.capture();
+            }
+            group.pending.fetch_sub(1, std::memory_order_release);
+        }};
+
+        WorkerQueue& own{*m_queues[worker]};
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.tasks.push_back(std::move(wrapped));
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Calls the given function on the given worker as a member of the given
+     * group. An exception it throws is stored in the group like those of
+     * spawned tasks, so that the caller still reaches wait().
+     */
+    template<class F>
+    void call(std::size_t worker, TaskGroup& group, F function)
+    {
+        try {
+            function(worker);
+        } catch (...) {
+            group.capture();
+        }
+    }
+
+    /**
+     * Runs queued tasks on the given worker until every task of the given
+     * group has finished.
+     *
+     * @throws The first exception stored in the group, if any.
+     */
+    void wait(std::size_t worker, TaskGroup& group)
+    {
+        while (group.pending.load(std::memory_order_acquire) != 0) {
+            if (!run_one(worker)) {
+                std::this_thread::yield();
+            }
+        }
+        if (group.error) {
+            std::rethrow_exception(group.error);
+        }
+    }
+};
+
+/**
+ * Merges the sorted ranges [first_1, last_1) and [first_2, last_2) into
+ * `out` by moving elements, splitting large merges into parallel tasks.
+ *
+ * The longer range is split at its middle element, and the shorter range at
+ * the first position not ordered before that element. The two halves of the
+ * output are then independent merges.
+ */
+template<class T, class C>
+void parallel_merge(
+    WorkStealingPool& pool,
+    std::size_t worker,
+    T* first_1, T* last_1,
+    T* first_2, T* last_2,
+    T* out,
+    C comp
+)
+{
+    const auto size_1 = static_cast<std::size_t>(last_1 - first_1);
+    const auto size_2 = static_cast<std::size_t>(last_2 - first_2);
+
+    if (size_1 + size_2 <= PARALLEL_MERGE_GRAIN) {
+        std::merge(
+            std::make_move_iterator(first_1), std::make_move_iterator(last_1),
+            std::make_move_iterator(first_2), std::make_move_iterator(last_2),
+            out, comp
+        );
+        return;
+    }
+
+    // Keep the first range the longer one.
+    if (size_1 < size_2) {
+        // Elements of the second range must still precede equal elements of
+        // the first, so the split below uses upper_bound() in that case.
+        T* const mid_2{first_2 + size_2 / 2};
+        T* const mid_1{std::upper_bound(first_1, last_1, *mid_2, comp)};
+        T* const mid_out{out + (mid_1 - first_1) + (mid_2 - first_2)};
+
+        WorkStealingPool::TaskGroup group;
+        pool.spawn(worker, group, [&, mid_1, mid_2](std::size_t runner) {
+            parallel_merge(pool, runner, first_1, mid_1, first_2, mid_2, out, comp);
+        });
+        pool.call(worker, group, [&, mid_1, mid_2](std::size_t runner) {
+            parallel_merge(pool, runner, mid_1, last_1, mid_2, last_2, mid_out, comp);
+        });
+        pool.wait(worker, group);
+        return;
+    }
+
+    T* const mid_1{first_1 + size_1 / 2};
+    T* const mid_2{std::lower_bound(first_2, last_2, *mid_1, comp)};
+    T* const mid_out{out + (mid_1 - first_1) + (mid_2 - first_2)};
+
+    WorkStealingPool::TaskGroup group;
+    pool.spawn(worker, group, [&, mid_1, mid_2](std::size_t runner) {
+        parallel_merge(pool, runner, first_1, mid_1, first_2, mid_2, out, comp);
+    });
+    pool.call(worker, group, [&, mid_1, mid_2](std::size_t runner) {
+        parallel_merge(pool, runner, mid_1, last_1, mid_2, last_2, mid_out, comp);
+    });
+    pool.wait(worker, group);
+}
+
+/**
+ * Sorts `size` elements of `values` by parallel merge sort, using the
+ * equally long `scratch` array as merge buffer.
+ *
+ * Each level of recursion merges from one array into the other, so no
+ * elements are copied back between levels.
+ *
+ * @param into_scratch If `true`, the sorted elements end up in `scratch`
+ *                     instead of `values`.
+ * @param grain Ranges of at most this many elements are sorted by a single
+ *              call of sort_array().
+ */
+template<class T, class C>
+void parallel_merge_sort(
+    WorkStealingPool& pool,
+    std::size_t worker,
+    T* values,
+    T* scratch,
+    std::size_t size,
+    bool into_scratch,
+    std::size_t grain,
+    C comp
+)
+{
+    if (size <= grain) {
+        sort_array(values, size, comp);
+        if (into_scratch) {
+            std::move(values, values + size, scratch);
+        }
+        return;
+    }
+
+    // Sort both halves into the array that is not the destination, then
+    // merge them into the destination.
+    const std::size_t half{size / 2};
+    WorkStealingPool::TaskGroup group;
+    pool.spawn(worker, group, [&](std::size_t runner) {
+        parallel_merge_sort(pool, runner, values, scratch, half, !into_scratch, grain, comp);
+    });
+    pool.call(worker, group, [&](std::size_t runner) {
+        parallel_merge_sort(
+            pool, runner, values + half, scratch + half, size - half, !into_scratch, grain, comp
+        );
+    });
+    pool.wait(worker, group);
+
+    T* const source{into_scratch ? values : scratch};
+    T* const destination{into_scratch ? scratch : values};
+    parallel_merge(
+        pool, worker,
+        source, source + half,
+        source + half, source + size,
+        destination, comp
+    );
+}
+
+} // end namespace sort_detail
+
+/**
+ * Sorts the given array of consecutive elements using multiple threads.
+ *
+ * The array is sorted by a parallel merge sort running on a work-stealing
+ * pool of threads. The array is split in halves recursively until the
+ * pieces are small enough to be sorted by sort_array(), with several pieces
+ * per thread so that threads which finish early can steal work. Pairs of
+ * sorted pieces are then merged into a scratch array of the same size, and
+ * large merges are themselves split into independent merges that run in
+ * parallel. Merges alternate between the array and the scratch array, so
+ * every element is moved once per level.
+ *
+ * The sort is not stable. Elements must be default constructible and move
+ * assignable.
+ *
+ * If sorting throws on any thread, for example std::bad_alloc from the
+ * buffers allocated by sort_array() for radix sort and multikey quicksort,
+ * the exception is rethrown on the calling thread once the tasks already
+ * started have finished. The order of the array is then unspecified, and
+ * elements moved into the scratch array at that point are left moved-from.
+ *
+ * This function is used in lab assignment 0.2.
+ *
+ * @tparam T Array content type.
+ * @tparam C Comparison function type.
+ * @param values Mutable pointer to array contents.
+ * @param size Array length.
+ * @param thread_count Number of threads, or 0 to use one thread per
+ *                     hardware thread.
+ * @param comp Strict weak ordering of the elements.
+ */
+template<class T, class C = std::less<>>
+void parallel_sort_array(T* values, std::size_t size, std::size_t thread_count = 0, C comp = C{})
+{
+    if (thread_count == 0) {
+        // hardware_concurrency() may return 0 if the count is unknown.
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // Small arrays are not worth starting threads for.
+    if (thread_count == 1 || size <= 2 * sort_detail::PARALLEL_SORT_GRAIN) {
+        sort_array(values, size, comp);
+        return;
+    }
+
+    const std::size_t grain{std::max(
+        size / (thread_count * sort_detail::TASKS_PER_THREAD),
+        sort_detail::PARALLEL_SORT_GRAIN
+    )};
+
+    std::vector<T> scratch(size);
+    sort_detail::WorkStealingPool pool(thread_count);
+    sort_detail::parallel_merge_sort(pool, 0, values, scratch.data(), size, false, grain, comp);
+}
+
 #endif //ECEE_2160_LAB_REPORTS_LAB0_UTILS_H
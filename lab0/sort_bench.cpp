@@ -0,0 +1,481 @@
+/*
+ * ECEE 2160 Lab Assignment 0 string sorting benchmarks.
+ *
+ * Times sort_array() on arrays of std::string, which uses multikey
+ * quicksort, against comparison sorts that compare whole strings and against
+ * sorting a StringPool, over a sweep of array sizes. The strings are either
+ * log keys that share long prefixes or short random strings. Over the same
+ * sizes, sort_array() on random signed and unsigned integers of 8, 16, 32
+ * and 64 bits, which uses radix sort, is timed against pattern-defeating
+ * quicksort and std::sort. The largest
+ * array of log keys is also sorted by parallel_sort_array() with one, two,
+ * four and so on threads up to the number of hardware threads, to measure
+ * how the parallel sort scales. The same thread counts are timed on arrays
+ * of 32- and 64-bit random integers of 10^7 elements up to 10^8 elements,
+ * which parallel_sort_array() sorts by radix sort within each task. Results
+ * are written to standard output as JSON.
+ *
+ * The largest integer arrays take about three times their own size in
+ * memory, 2.4 GB for 10^8 64-bit integers, so --max-int-size lowers the
+ * largest integer array, and 0 skips the integer arrays.
+ *
+ * Usage: lab0-bench [--max-size N] [--max-int-size N] [--warmup N] [--repeats N]
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-01
+ *
+ */
+
+#include "lab0_utils.h"
+#include "string_pool.h"
+
+#include <algorithm>        // for std::sort, std::is_sorted
+#include <chrono>           // for std::chrono::steady_clock
+#include <cstdint>          // for std::int8_t, ..., std::uint64_t
+#include <cstdlib>          // for std::strtoull, std::exit
+#include <cstring>          // for std::strcmp
+#include <functional>       // for std::function
+#include <iostream>         // for std::cout, std::cerr
+#include <random>           // for std::mt19937_64
+#include <sstream>          // for std::istringstream
+#include <string>           // for std::string, std::to_string
+#include <thread>           // for std::thread
+#include <utility>          // for std::move
+#include <vector>           // for std::vector
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Smallest array size in the sweep.
+constexpr std::size_t MIN_SIZE{1u << 10u};
+
+/// Default largest array size in the sweep.
+constexpr std::size_t DEFAULT_MAX_SIZE{1u << 22u};
+
+/// Smallest integer array size in the thread scaling sweep.
+constexpr std::size_t MIN_INT_SIZE{10000000};
+
+/// Default largest integer array size in the thread scaling sweep.
+constexpr std::size_t DEFAULT_MAX_INT_SIZE{100000000};
+
+/// Default number of untimed runs before the timed runs.
+constexpr std::size_t DEFAULT_WARMUP{1};
+
+/// Default number of timed runs.
+constexpr std::size_t DEFAULT_REPEATS{5};
+
+/// Number of elements each timed run should sort at least. Small arrays are
+/// sorted repeatedly within a run so that runs are long enough to time.
+constexpr std::size_t MIN_RUN_ELEMENTS{std::size_t{1} << 22u};
+
+/// Seed of the string and integer generators, so that every run sorts the same input.
+constexpr std::uint64_t SEED{2160};
+
+/**
+ * Benchmark settings taken from the command line.
+ */
+struct Options {
+    std::size_t max_size{DEFAULT_MAX_SIZE};
+    std::size_t max_int_size{DEFAULT_MAX_INT_SIZE};
+    std::size_t warmup{DEFAULT_WARMUP};
+    std::size_t repeats{DEFAULT_REPEATS};
+};
+
+/**
+ * Summary of the timed runs of one benchmark.
+ */
+struct Measurement {
+    /// Fastest run, in seconds.
+    double min_seconds;
+    /// Median run, in seconds.
+    double median_seconds;
+};
+
+/**
+ * Runs the given function `warmup` times untimed, then `repeats` times while
+ * timing each run. The setup function is called before every run, outside
+ * of the timed region.
+ */
+Measurement measure(
+    const std::function<void()>& setup,
+    const std::function<void()>& run,
+    const Options& options
+)
+{
+    for (std::size_t i{0}; i < options.warmup; ++i) {
+        setup();
+        run();
+    }
+
+    std::vector<double> seconds;
+    seconds.reserve(options.repeats);
+
+    for (std::size_t i{0}; i < options.repeats; ++i) {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto stop = std::chrono::steady_clock::now();
+        seconds.push_back(std::chrono::duration<double>(stop - start).count());
+    }
+
+    std::sort(seconds.begin(), seconds.end());
+    return Measurement{seconds.front(), seconds[seconds.size() / 2]};
+}
+
+/**
+ * Writes one benchmark result as a JSON object.
+ *
+ * @param name Name of the benchmarked sort.
+ * @param data Name of the input data set.
+ * @param unit Plural name of the array elements, used to name the rate.
+ * @param size Number of elements per array.
+ * @param iterations Number of arrays sorted within each timed run.
+ * @param threads Number of threads sorting each array.
+ */
+void write_result(
+    std::ostream& out,
+    bool& first,
+    const char* name,
+    const char* data,
+    const char* unit,
+    std::size_t size,
+    std::size_t iterations,
+    std::size_t threads,
+    const Measurement& m
+)
+{
+    const auto calls = static_cast<double>(iterations);
+    out << (first ? "\n" : ",\n") << "    {"
+        << "\"benchmark\": \"" << name << "\", "
+        << "\"data\": \"" << data << "\", "
+        << "\"size\": " << size << ", "
+        << "\"iterations\": " << iterations << ", "
+        << "\"threads\": " << threads << ", "
+        << "\"seconds_min\": " << m.min_seconds / calls << ", "
+        << "\"seconds_median\": " << m.median_seconds / calls << ", "
+        << "\"million_" << unit << "_per_s\": " << static_cast<double>(size) * calls / m.min_seconds / 1e6
+        << '}';
+    first = false;
+}
+
+/**
+ * Returns the given number as a decimal string padded with zeros to the
+ * given width.
+ */
+std::string zero_padded(std::uint64_t value, std::size_t width)
+{
+    std::string digits{std::to_string(value)};
+    if (digits.size() < width) {
+        digits.insert(0, width - digits.size(), '0');
+    }
+    return digits;
+}
+
+/**
+ * Returns the given number of log keys, which share a 29-character prefix
+ * and differ mostly in their trailing timestamp and request number, like
+ *
+ *     service/ecee-2160/2020-07-01T13:07:42.118305/request-00412737
+ */
+std::vector<std::string> make_log_keys(std::size_t count)
+{
+    std::mt19937_64 rng{SEED};
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t i{0}; i < count; ++i) {
+        const std::uint64_t r{rng()};
+        keys.push_back(
+            "service/ecee-2160/2020-07-01T"
+            + zero_padded(r % 24, 2) + ':'
+            + zero_padded((r >> 8u) % 60, 2) + ':'
+            + zero_padded((r >> 16u) % 60, 2) + '.'
+            + zero_padded((r >> 24u) % 1000000, 6)
+            + "/request-" + zero_padded(i, 8)
+        );
+    }
+    return keys;
+}
+
+/**
+ * Returns the given number of random lowercase strings of 4 to 15
+ * characters, which fit in the small string buffer.
+ */
+std::vector<std::string> make_random_words(std::size_t count)
+{
+    std::mt19937_64 rng{SEED};
+    std::vector<std::string> words;
+    words.reserve(count);
+    for (std::size_t i{0}; i < count; ++i) {
+        std::uint64_t r{rng()};
+        std::string word(4 + r % 12, 'a');
+        for (auto& ch : word) {
+            r = r * 6364136223846793005u + 1442695040888963407u;
+            ch = static_cast<char>('a' + (r >> 59u) % 26);
+        }
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+/**
+ * Returns the given number of uniformly distributed random integers.
+ */
+template<class T>
+std::vector<T> make_random_integers(std::size_t count)
+{
+    std::mt19937_64 rng{SEED};
+    std::vector<T> values(count);
+    for (auto& value : values) {
+        value = static_cast<T>(rng());
+    }
+    return values;
+}
+
+/**
+ * Times sort_array() by radix sort, by pattern-defeating quicksort and
+ * std::sort on arrays of the given number of random integers.
+ */
+template<class T>
+void bench_integer_sorts(std::ostream& out, bool& first, const char* data, std::size_t size, const Options& options)
+{
+    const std::vector<T> input{make_random_integers<T>(size)};
+    const std::size_t iterations{std::max(MIN_RUN_ELEMENTS / size, std::size_t{1})};
+    std::vector<std::vector<T>> arrays(iterations);
+
+    // Runs the given sort on fresh copies of the input.
+    const auto bench_sort = [&](const char* name, void (*sort)(std::vector<T>&)) {
+        const Measurement m{measure(
+            [&] {
+                for (auto& array : arrays) {
+                    array = input;
+                }
+            },
+            [&] {
+                for (auto& array : arrays) {
+                    sort(array);
+                }
+            },
+            options
+        )};
+        if (!std::is_sorted(arrays.front().begin(), arrays.front().end())) {
+            std::cerr << name << " failed to sort " << data << '\n';
+            std::exit(1);
+        }
+        write_result(out, first, name, data, "elements", size, iterations, 1, m);
+    };
+
+    bench_sort("radix_sort", [](std::vector<T>& array) {
+        sort_array(array.data(), array.size());
+    });
+    // A comparison other than std::less selects pattern-defeating quicksort.
+    bench_sort("pdqsort", [](std::vector<T>& array) {
+        sort_array(array.data(), array.size(), [](T a, T b) { return a < b; });
+    });
+    bench_sort("std_sort", [](std::vector<T>& array) {
+        std::sort(array.begin(), array.end());
+    });
+}
+
+/**
+ * Returns the thread counts of the scaling benchmarks: one, two, four and so
+ * on up to the number of hardware threads, which is always included.
+ */
+std::vector<std::size_t> scaling_thread_counts()
+{
+    // hardware_concurrency() may return 0 if the count is unknown.
+    const std::size_t hardware_threads{std::max(std::thread::hardware_concurrency(), 1u)};
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads{1}; threads < hardware_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(hardware_threads);
+    return thread_counts;
+}
+
+/**
+ * Times parallel_sort_array() on an array of the given number of random
+ * integers with each of the scaling thread counts.
+ */
+template<class T>
+void bench_integer_scaling(std::ostream& out, bool& first, const char* data, std::size_t size, const Options& options)
+{
+    const std::vector<T> input{make_random_integers<T>(size)};
+    std::vector<T> array;
+
+    for (const std::size_t threads : scaling_thread_counts()) {
+        const Measurement m{measure(
+            [&] { array = input; },
+            [&] { parallel_sort_array(array.data(), array.size(), threads); },
+            options
+        )};
+        if (!std::is_sorted(array.begin(), array.end())) {
+            std::cerr << "parallel_sort_array failed to sort " << data << '\n';
+            std::exit(1);
+        }
+        write_result(out, first, "parallel_sort_array", data, "elements", size, 1, threads, m);
+    }
+}
+
+/**
+ * Parses the command line into the given options.
+ *
+ * @return `false` if the command line is malformed.
+ */
+bool parse_options(int argc, char* argv[], Options& options)
+{
+    for (int i{1}; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const auto value = static_cast<std::size_t>(std::strtoull(argv[i + 1], nullptr, 10));
+        if (std::strcmp(argv[i], "--max-size") == 0) {
+            options.max_size = value;
+        } else if (std::strcmp(argv[i], "--max-int-size") == 0) {
+            options.max_int_size = value;
+        } else if (std::strcmp(argv[i], "--warmup") == 0) {
+            options.warmup = value;
+        } else if (std::strcmp(argv[i], "--repeats") == 0) {
+            options.repeats = value;
+        } else {
+            return false;
+        }
+    }
+    return options.repeats != 0;
+}
+
+} // end namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--max-size N] [--max-int-size N] [--warmup N] [--repeats N]\n";
+        return 1;
+    }
+
+    auto& out = std::cout;
+    bool first{true};
+
+    out << "{\n"
+        << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+        << "  \"warmup\": " << options.warmup << ",\n"
+        << "  \"repeats\": " << options.repeats << ",\n"
+        << "  \"results\": [";
+
+    for (std::size_t size{MIN_SIZE}; size <= options.max_size; size *= 4) {
+        const std::size_t iterations{std::max(MIN_RUN_ELEMENTS / size, std::size_t{1})};
+
+        const auto bench_data = [&](const char* data, const std::vector<std::string>& input) {
+            std::vector<std::vector<std::string>> arrays(iterations);
+
+            // Runs the given sort on fresh copies of the input.
+            const auto bench_sort = [&](const char* name, void (*sort)(std::vector<std::string>&)) {
+                const Measurement m{measure(
+                    [&] {
+                        for (auto& array : arrays) {
+                            array = input;
+                        }
+                    },
+                    [&] {
+                        for (auto& array : arrays) {
+                            sort(array);
+                        }
+                    },
+                    options
+                )};
+                if (!std::is_sorted(arrays.front().begin(), arrays.front().end())) {
+                    std::cerr << name << " failed to sort " << data << '\n';
+                    std::exit(1);
+                }
+                write_result(out, first, name, data, "strings", size, iterations, 1, m);
+            };
+
+            bench_sort("multikey_quicksort", [](std::vector<std::string>& array) {
+                sort_array(array.data(), array.size());
+            });
+            // A comparison other than std::less selects pattern-defeating
+            // quicksort on whole strings.
+            bench_sort("pdqsort", [](std::vector<std::string>& array) {
+                sort_array(array.data(), array.size(), [](const std::string& a, const std::string& b) {
+                    return a < b;
+                });
+            });
+            bench_sort("std_sort", [](std::vector<std::string>& array) {
+                std::sort(array.begin(), array.end());
+            });
+
+            // Sorts pools read from the same strings, one per line.
+            std::string text;
+            for (const auto& string : input) {
+                text += string;
+                text += '\n';
+            }
+            std::vector<StringPool> pools(iterations);
+            const Measurement m{measure(
+                [&] {
+                    for (auto& pool : pools) {
+                        pool = StringPool();
+                        std::istringstream stream{text};
+                        pool.read_all(stream);
+                    }
+                },
+                [&] {
+                    for (auto& pool : pools) {
+                        pool.sort();
+                    }
+                },
+                options
+            )};
+            if (!std::is_sorted(pools.front().begin(), pools.front().end())) {
+                std::cerr << "string_pool failed to sort " << data << '\n';
+                std::exit(1);
+            }
+            write_result(out, first, "string_pool", data, "strings", size, iterations, 1, m);
+        };
+
+        bench_data("log_keys", make_log_keys(size));
+        bench_data("random_words", make_random_words(size));
+
+        bench_integer_sorts<std::int8_t>(out, first, "random_int8", size, options);
+        bench_integer_sorts<std::int16_t>(out, first, "random_int16", size, options);
+        bench_integer_sorts<std::int32_t>(out, first, "random_int32", size, options);
+        bench_integer_sorts<std::int64_t>(out, first, "random_int64", size, options);
+        bench_integer_sorts<std::uint8_t>(out, first, "random_uint8", size, options);
+        bench_integer_sorts<std::uint16_t>(out, first, "random_uint16", size, options);
+        bench_integer_sorts<std::uint32_t>(out, first, "random_uint32", size, options);
+        bench_integer_sorts<std::uint64_t>(out, first, "random_uint64", size, options);
+    }
+
+    // Thread scaling of the parallel sort, on the largest array of the sweep.
+    std::size_t largest{MIN_SIZE};
+    while (largest * 4 <= options.max_size) {
+        largest *= 4;
+    }
+    if (largest <= options.max_size) {
+        const std::vector<std::string> input{make_log_keys(largest)};
+        std::vector<std::string> array;
+
+        for (const std::size_t threads : scaling_thread_counts()) {
+            const Measurement m{measure(
+                [&] { array = input; },
+                [&] { parallel_sort_array(array.data(), array.size(), threads); },
+                options
+            )};
+            if (!std::is_sorted(array.begin(), array.end())) {
+                std::cerr << "parallel_sort_array failed to sort log_keys\n";
+                std::exit(1);
+            }
+            write_result(out, first, "parallel_sort_array", "log_keys", "strings", largest, 1, threads, m);
+        }
+    }
+
+    // Thread scaling of the parallel sort on integers.
+    for (std::size_t size{MIN_INT_SIZE}; size <= options.max_int_size; size *= 10) {
+        bench_integer_scaling<std::int32_t>(out, first, "random_int32", size, options);
+        bench_integer_scaling<std::int64_t>(out, first, "random_int64", size, options);
+    }
+
+    out << "\n  ]\n}\n";
+
+    return 0;
+}
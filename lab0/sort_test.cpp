@@ -0,0 +1,249 @@
+/*
+ * ECEE 2160 Lab Assignment 0 sorting tests.
+ *
+ * Checks sort_array() with its default ordering, which sorts signed and
+ * unsigned integers of 8, 16, 32 and 64 bits by radix sort and strings by
+ * multikey quicksort, sort_array() with a custom comparison, which sorts by
+ * pattern-defeating quicksort, radix sort and multikey quicksort called
+ * directly, and parallel_sort_array() with several thread counts, all
+ * against std::sort. Array sizes fall on either side of
+ * the insertion sort, radix sort, multikey quicksort and parallel sort
+ * thresholds, and the inputs include random, sorted, reversed, organ pipe,
+ * constant and few-valued arrays. Strings include empty strings, shared
+ * prefixes, embedded null characters and characters above 0x7f.
+ *
+ * Failures are written to standard error, and the exit status is nonzero if
+ * any check fails.
+ *
+ * Usage: lab0-sort-test
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-01
+ *
+ */
+
+#include "lab0_utils.h"
+
+#include <algorithm>    // for std::sort, std::reverse
+#include <cstddef>      // for std::size_t, std::ptrdiff_t
+#include <cstdint>      // for std::int8_t, ..., std::uint64_t
+#include <functional>   // for std::less, std::greater
+#include <iostream>     // for std::cout, std::cerr
+#include <random>       // for std::mt19937_64
+#include <string>       // for std::string
+#include <type_traits>  // for std::is_floating_point_v, std::is_same_v
+#include <vector>       // for std::vector
+
+// Using anonymous namespace to given symbols internal linkage.
+namespace {
+
+/// Array sizes tested, on either side of the sort thresholds. The largest
+/// sizes exceed twice the parallel sort grain, so they are sorted on several
+/// threads.
+constexpr std::size_t SIZES[] = {0, 1, 2, 23, 24, 25, 63, 64, 65, 1023, 1024, 1025, 5000, 40000, 100001};
+
+/// Thread counts passed to parallel_sort_array(). Zero uses one thread per
+/// hardware thread.
+constexpr std::size_t THREAD_COUNTS[] = {0, 1, 2, 3, 8};
+
+/// Orders of the arrays tested.
+enum class Pattern {
+    /// Uniformly distributed values.
+    Random,
+    /// Values already in ascending order.
+    Sorted,
+    /// Values in descending order.
+    Reversed,
+    /// Ascending first half followed by a descending second half.
+    OrganPipe,
+    /// Every value equal.
+    Constant,
+    /// Random values drawn from a set of four.
+    FewValues,
+};
+
+constexpr Pattern PATTERNS[] = {
+    Pattern::Random, Pattern::Sorted, Pattern::Reversed, Pattern::OrganPipe, Pattern::Constant, Pattern::FewValues
+};
+
+/// Number of checks run and failed.
+std::size_t checks{0};
+std::size_t failures{0};
+
+/**
+ * Records one check, printing the given description if it failed.
+ */
+template<typename... Args>
+void check(bool passed, const Args&... description)
+{
+    ++checks;
+    if (!passed) {
+        ++failures;
+        std::cerr << "FAILED:";
+        ((std::cerr << ' ' << description), ...);
+        std::cerr << '\n';
+    }
+}
+
+/**
+ * Returns the name of the given pattern for messages.
+ */
+const char* pattern_name(Pattern pattern)
+{
+    switch (pattern) {
+        case Pattern::Random:
+            return "random";
+        case Pattern::Sorted:
+            return "sorted";
+        case Pattern::Reversed:
+            return "reversed";
+        case Pattern::OrganPipe:
+            return "organ-pipe";
+        case Pattern::Constant:
+            return "constant";
+        case Pattern::FewValues:
+            return "few-values";
+    }
+    return "unknown";
+}
+
+/**
+ * Returns a random value of the given integer or floating point type. The
+ * values cover the whole range of integers, negative values included.
+ */
+template<typename T>
+T random_value(std::uint64_t r)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(static_cast<std::int64_t>(r >> 11u) - (std::int64_t{1} << 52u)) / T{1024};
+    } else {
+        return static_cast<T>(r);
+    }
+}
+
+/**
+ * Returns a random string of up to 40 characters. Half of the strings share
+ * a long prefix, and the characters include null characters and characters
+ * above 0x7f, which must order after the others.
+ */
+template<>
+std::string random_value<std::string>(std::uint64_t r)
+{
+    constexpr char ALPHABET[] = {'\0', 'a', 'b', 'c', 'z', '\x7f', '\x80', '\xff'};
+    std::string value{(r & 1u) != 0 ? "service/ecee-2160/2020-07-01T" : ""};
+    r >>= 1u;
+    const std::size_t length{r % 12};
+    for (std::size_t i{0}; i < length; ++i) {
+        r = r * 6364136223846793005u + 1442695040888963407u;
+        value += ALPHABET[(r >> 61u) % sizeof(ALPHABET)];
+    }
+    return value;
+}
+
+/**
+ * Returns an array of the given size whose values follow the given pattern.
+ */
+template<typename T>
+std::vector<T> make_values(std::size_t size, Pattern pattern)
+{
+    std::mt19937_64 rng{size * 31 + static_cast<std::size_t>(pattern)};
+    std::vector<T> values(size);
+    for (auto& value : values) {
+        value = random_value<T>(rng());
+    }
+    switch (pattern) {
+        case Pattern::Random:
+            break;
+        case Pattern::Sorted:
+            std::sort(values.begin(), values.end());
+            break;
+        case Pattern::Reversed:
+            std::sort(values.begin(), values.end(), std::greater<>());
+            break;
+        case Pattern::OrganPipe:
+            std::sort(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(size / 2));
+            std::sort(values.begin() + static_cast<std::ptrdiff_t>(size / 2), values.end(), std::greater<>());
+            break;
+        case Pattern::Constant:
+            for (auto& value : values) {
+                value = random_value<T>(7);
+            }
+            break;
+        case Pattern::FewValues:
+            for (auto& value : values) {
+                value = random_value<T>(rng() % 4);
+            }
+            break;
+    }
+    return values;
+}
+
+/**
+ * Checks every sort of the given element type against std::sort, with every
+ * size and pattern.
+ */
+template<typename T>
+void check_sorts(const char* type)
+{
+    for (const std::size_t size : SIZES) {
+        for (const Pattern pattern : PATTERNS) {
+            const char* const name{pattern_name(pattern)};
+            const std::vector<T> input{make_values<T>(size, pattern)};
+            std::vector<T> expected{input};
+            std::sort(expected.begin(), expected.end());
+
+            std::vector<T> values{input};
+            sort_array(values.data(), values.size());
+            check(values == expected, "sort_array", type, name, "size", size);
+
+            // A comparison other than std::less selects pattern-defeating
+            // quicksort.
+            values = input;
+            sort_array(values.data(), values.size(), [](const T& a, const T& b) { return a < b; });
+            check(values == expected, "sort_array pdqsort", type, name, "size", size);
+
+            if constexpr (sort_detail::RADIX_SORTABLE<T, std::less<>>) {
+                values = input;
+                sort_detail::radix_sort(values.data(), values.size());
+                check(values == expected, "radix_sort", type, name, "size", size);
+            }
+            if constexpr (std::is_same_v<T, std::string>) {
+                values = input;
+                sort_detail::string_sort(values.data(), values.size());
+                check(values == expected, "string_sort", type, name, "size", size);
+            }
+
+            for (const std::size_t threads : THREAD_COUNTS) {
+                values = input;
+                parallel_sort_array(values.data(), values.size(), threads);
+                check(values == expected, "parallel_sort_array", type, name, "size", size, "threads", threads);
+            }
+
+            // Descending order exercises both sorts with another comparison.
+            std::vector<T> descending{expected};
+            std::reverse(descending.begin(), descending.end());
+            values = input;
+            parallel_sort_array(values.data(), values.size(), 3, std::greater<>());
+            check(values == descending, "parallel_sort_array descending", type, name, "size", size);
+        }
+    }
+}
+
+} // end namespace
+
+int main()
+{
+    check_sorts<std::int8_t>("int8_t");
+    check_sorts<std::int16_t>("int16_t");
+    check_sorts<std::int32_t>("int32_t");
+    check_sorts<std::int64_t>("int64_t");
+    check_sorts<std::uint8_t>("uint8_t");
+    check_sorts<std::uint16_t>("uint16_t");
+    check_sorts<std::uint32_t>("uint32_t");
+    check_sorts<std::uint64_t>("uint64_t");
+    check_sorts<double>("double");
+    check_sorts<std::string>("string");
+
+    std::cout << checks - failures << " of " << checks << " checks passed\n";
+    return failures == 0 ? 0 : 1;
+}
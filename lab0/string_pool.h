@@ -0,0 +1,294 @@
+/*
+ * ECEE 2160 Lab Assignment 0 string pool.
+ *
+ * A StringPool holds many short strings in a single contiguous buffer, the
+ * arena, rather than in separately allocated std::strings. All members are
+ * defined in this header, so no implementation (.cpp) file is required.
+ *
+ * Author:  Brian Schubert
+ * Date:    2020-07-01
+ *
+ * References
+ * ==========
+ *
+ *  - P. Bohannon, P. McIlroy and R. Rastogi, "Main-memory index structures
+ *    with fixed-size partial keys," in Proc. SIGMOD, 2001.
+ *
+ */
+
+#ifndef ECEE_2160_LAB_REPORTS_STRING_POOL_H
+#define ECEE_2160_LAB_REPORTS_STRING_POOL_H
+
+#include "lab0_utils.h"
+
+#include <algorithm>        // for std::min
+#include <cctype>           // for std::isspace
+#include <cstddef>          // for std::size_t, std::ptrdiff_t
+#include <cstdint>          // for std::uint64_t
+#include <istream>          // for std::istream
+#include <iterator>         // for std::input_iterator_tag
+#include <string_view>      // for std::string_view
+#include <vector>           // for std::vector
+
+/**
+ * A sequence of strings stored back to back in one buffer.
+ *
+ * Each string is described by a 24-byte record holding its offset in the
+ * arena, its length, and eight of its characters as an integer prefix.
+ * Reading strings appends their characters to the arena, so a pool of a
+ * million strings makes a handful of allocations rather than one per
+ * string. Sorting the pool moves only the records, and compares the inline
+ * prefixes first, so the arena is read only when two strings share the
+ * characters held by their prefixes.
+ */
+class StringPool {
+    /**
+     * Describes one string of the pool.
+     */
+    struct Record {
+        /// Characters of the string from position m_key_depth on, as built
+        /// by sort_detail::string_key().
+        std::uint64_t prefix;
+        /// Position of the first character in the arena.
+        std::size_t offset;
+        /// Number of characters.
+        std::size_t length;
+    };
+
+    /// Characters of all strings, with any whitespace that separated them
+    /// in the input.
+    std::vector<char> m_arena;
+
+    /// Records of the strings, in their current order.
+    std::vector<Record> m_records;
+
+    /// Position of the first character held by the record prefixes. Every
+    /// string of the pool has at least this many characters, and they all
+    /// agree on them.
+    std::size_t m_key_depth{0};
+
+    /// Size of the blocks read by read_all().
+    static constexpr std::size_t READ_BLOCK{std::size_t{1} << 16u};
+
+    /**
+     * Returns `true` if the given character separates strings.
+     */
+    static bool is_separator(char ch)
+    {
+        return std::isspace(static_cast<unsigned char>(ch)) != 0;
+    }
+
+    /**
+     * Sets the prefix of every record to the characters starting at the
+     * given position.
+     */
+    void load_prefixes(std::size_t depth)
+    {
+        for (auto& record : m_records) {
+            record.prefix = sort_detail::string_key(m_arena.data() + record.offset, record.length, depth);
+        }
+        m_key_depth = depth;
+    }
+
+    /**
+     * Returns the number of leading characters shared by every string of
+     * the pool.
+     */
+    std::size_t shared_prefix() const
+    {
+        if (m_records.empty()) {
+            return 0;
+        }
+        const char* const first{m_arena.data() + m_records[0].offset};
+        std::size_t shared{m_records[0].length};
+        for (const auto& record : m_records) {
+            const char* const string{m_arena.data() + record.offset};
+            const std::size_t limit{std::min(shared, record.length)};
+            std::size_t i{0};
+            while (i < limit && string[i] == first[i]) {
+                ++i;
+            }
+            shared = i;
+        }
+        return shared;
+    }
+
+    /**
+     * Adds a record for the characters of the arena in [offset, offset + length).
+     */
+    void add_record(std::size_t offset, std::size_t length)
+    {
+        // A new string need not share the characters skipped by the
+        // prefixes of the others.
+        if (m_key_depth != 0) {
+            load_prefixes(0);
+        }
+        const std::uint64_t prefix{sort_detail::string_key(m_arena.data() + offset, length, 0)};
+        m_records.push_back(Record{prefix, offset, length});
+    }
+
+  public:
+    /**
+     * An iterator over the strings of a pool, yielding them as
+     * std::string_view.
+     *
+     * Dereferencing returns a view by value rather than a reference to an
+     * element, so the iterator is only an input iterator, although it may be
+     * copied and traversed more than once.
+     */
+    class Iterator {
+        const StringPool* m_pool;
+        std::size_t m_index;
+
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        Iterator(const StringPool* pool, std::size_t index) : m_pool{pool}, m_index{index} {}
+
+        std::string_view operator*() const { return (*m_pool)[m_index]; }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator prev{*this};
+            ++m_index;
+            return prev;
+        }
+
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+    };
+
+    /**
+     * Reads the given number of whitespace separated strings from the given
+     * stream into the arena, like repeated `in >> str` would, but without
+     * allocating a std::string for each.
+     *
+     * Characters are read one at a time, so that an interactive stream is
+     * not read past the last string.
+     *
+     * @return `false` if the stream ended or failed before `count` strings
+     *         were read.
+     */
+    bool read(std::istream& in, std::size_t count)
+    {
+        for (std::size_t i{0}; i < count; ++i) {
+            // Skip leading whitespace and fail if no string follows.
+            if (!(in >> std::ws) || in.peek() == std::istream::traits_type::eof()) {
+                return false;
+            }
+
+            const std::size_t offset{m_arena.size()};
+            for (auto next = in.peek();
+                 next != std::istream::traits_type::eof()
+                 && !is_separator(std::istream::traits_type::to_char_type(next));
+                 next = in.peek()) {
+                m_arena.push_back(static_cast<char>(in.get()));
+            }
+            add_record(offset, m_arena.size() - offset);
+        }
+        return true;
+    }
+
+    /**
+     * Reads the rest of the given stream into the arena in large blocks, and
+     * adds every whitespace separated string in it to the pool.
+     *
+     * The strings are found in the arena after reading, so their characters
+     * are never copied.
+     *
+     * @return The number of strings added.
+     */
+    std::size_t read_all(std::istream& in)
+    {
+        const std::size_t start{m_arena.size()};
+        std::size_t end{start};
+        while (in) {
+            m_arena.resize(end + READ_BLOCK);
+            in.read(m_arena.data() + end, static_cast<std::streamsize>(READ_BLOCK));
+            end += static_cast<std::size_t>(in.gcount());
+        }
+        m_arena.resize(end);
+
+        // Tokenize the new characters in place.
+        const std::size_t old_count{m_records.size()};
+        std::size_t pos{start};
+        while (pos < end) {
+            while (pos < end && is_separator(m_arena[pos])) {
+                ++pos;
+            }
+            const std::size_t offset{pos};
+            while (pos < end && !is_separator(m_arena[pos])) {
+                ++pos;
+            }
+            if (pos != offset) {
+                add_record(offset, pos - offset);
+            }
+        }
+        return m_records.size() - old_count;
+    }
+
+    /**
+     * Sorts the strings of the pool in lexicographic order.
+     *
+     * Records are compared by their prefixes, and by the characters that
+     * follow the prefix in the arena only if their prefixes are equal. If
+     * every string starts with the same characters, as log keys often do,
+     * the prefixes are first reloaded to hold the characters after them.
+     */
+    void sort()
+    {
+        const std::size_t depth{shared_prefix()};
+        if (depth != m_key_depth) {
+            load_prefixes(depth);
+        }
+
+        const char* const arena{m_arena.data()};
+        sort_array(m_records.data(), m_records.size(), [arena, depth](const Record& a, const Record& b) {
+            if (a.prefix != b.prefix) {
+                return a.prefix < b.prefix;
+            }
+            // Equal prefixes mean equal first characters, up to the end of
+            // the shorter string or the end of the prefix.
+            const std::size_t skip{std::min({a.length, b.length, depth + sort_detail::KEY_CHARS})};
+            return std::string_view(arena + a.offset + skip, a.length - skip)
+                   < std::string_view(arena + b.offset + skip, b.length - skip);
+        });
+    }
+
+    /**
+     * Returns the number of strings in the pool.
+     */
+    std::size_t size() const { return m_records.size(); }
+
+    /**
+     * Returns the number of bytes used by the arena.
+     */
+    std::size_t arena_size() const { return m_arena.size(); }
+
+    /**
+     * Returns the string at the given position. The view is invalidated by
+     * the next read.
+     */
+    std::string_view operator[](std::size_t index) const
+    {
+        const Record& record{m_records[index]};
+        return {m_arena.data() + record.offset, record.length};
+    }
+
+    Iterator begin() const { return Iterator(this, 0); }
+
+    Iterator end() const { return Iterator(this, m_records.size()); }
+};
+
+#endif //ECEE_2160_LAB_REPORTS_STRING_POOL_H
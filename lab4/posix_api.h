@@ -18,6 +18,9 @@
  * [so-unaligned-2] https://stackoverflow.com/questions/32062894/take-advantage-of-arm-unaligned-memory-access-while-writing-clean-c-code
  * [cpp-underlying] https://en.cppreference.com/w/cpp/types/underlying_type
  * [isocpp-guidelines] https://isocpp.github.io/CppCoreGuidelines/CppCoreGuidelines
+ * [fstat]      https://pubs.opengroup.org/onlinepubs/9699919799/functions/fstat.html
+ * [pread]      https://pubs.opengroup.org/onlinepubs/9699919799/functions/pread.html
+ * [fadvise]    https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_fadvise.html
  *
  */
 
@@ -28,6 +31,7 @@
 // is encountered.
 //#define POSIX_API_PRINT_DEBUG
 
+#include <cerrno>           // for errno, EINTR
 #include <cstddef>          // for std::byte
 #include <stdexcept>        // for std::runtime_error
 #include <type_traits>      // for std::underlying_type
@@ -35,7 +39,6 @@
 
 #ifdef POSIX_API_PRINT_DEBUG
 #include <iostream>
-#include <cerrno>
 #include <cstring>
 #endif
 
@@ -46,6 +49,7 @@ namespace raw_posix {
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 }
 
@@ -58,10 +62,19 @@ namespace raw_posix {
  * Note: we only define flags for the symbolic constants used in this lab.
  */
 enum class FileFlag : int {
+    ReadOnly = O_RDONLY,
     ReadWrite = O_RDWR,
     Sync = O_SYNC,
 };
 
+/**
+ * Access pattern hints accepted by posix_fadvise [fadvise].
+ */
+enum class FileAdvice : int {
+    Sequential = POSIX_FADV_SEQUENTIAL,
+    DontNeed = POSIX_FADV_DONTNEED,
+};
+
 /**
  * Lightweight handle class for a posix file descriptor.
  */
@@ -123,6 +136,109 @@ class File {
         return *this;
     }
 
+    /**
+     * Returns the size of this file in bytes, as reported by fstat [fstat].
+     *
+     * @throws std::runtime_error if the file could not be queried.
+     */
+    std::size_t size() const
+    {
+        struct raw_posix::stat file_status{};
+        if (raw_posix::fstat(m_fd, &file_status) != 0) {
+            throw std::runtime_error("failed to query file size");
+        }
+        return static_cast<std::size_t>(file_status.st_size);
+    }
+
+    /**
+     * Returns `true` if the file at the given path is this file, that is, if
+     * it resides on the same device with the same inode number [fstat].
+     * Returns `false` if there is no file at the path.
+     *
+     * @throws std::runtime_error if this file could not be queried.
+     */
+    bool is_same_file(const char* file_name) const
+    {
+        struct raw_posix::stat file_status{};
+        if (raw_posix::fstat(m_fd, &file_status) != 0) {
+            throw std::runtime_error("failed to query file");
+        }
+        struct raw_posix::stat other_status{};
+        if (raw_posix::stat(file_name, &other_status) != 0) {
+            return false;
+        }
+        return file_status.st_dev == other_status.st_dev && file_status.st_ino == other_status.st_ino;
+    }
+
+    /**
+     * Reads exactly `count` bytes starting at the given offset of this file
+     * into the buffer, without moving the file offset [pread]. Partial and
+     * interrupted reads are resumed.
+     *
+     * @return `true` on success, or `false` if an error occurred or the end
+     *         of the file was reached first.
+     */
+    bool read_at(void* buffer, std::size_t count, std::size_t offset) const
+    {
+        auto dst = static_cast<std::byte*>(buffer);
+        while (count != 0) {
+            const auto result = raw_posix::pread(m_fd, dst, count, static_cast<off_t>(offset));
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                return false;
+            }
+            const auto done = static_cast<std::size_t>(result);
+            dst += done;
+            count -= done;
+            offset += done;
+        }
+        return true;
+    }
+
+    /**
+     * Writes exactly `count` bytes from the buffer starting at the given
+     * offset of this file, without moving the file offset [pread]. Partial
+     * and interrupted writes are resumed.
+     *
+     * @return `true` on success, or `false` if an error occurred.
+     */
+    bool write_at(const void* buffer, std::size_t count, std::size_t offset) const
+    {
+        auto src = static_cast<const std::byte*>(buffer);
+        while (count != 0) {
+            const auto result = raw_posix::pwrite(m_fd, src, count, static_cast<off_t>(offset));
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                return false;
+            }
+            const auto done = static_cast<std::size_t>(result);
+            src += done;
+            count -= done;
+            offset += done;
+        }
+        return true;
+    }
+
+    /**
+     * Tells the kernel how the given byte range of this file will be
+     * accessed [fadvise]. A length of zero extends to the end of the file.
+     * Hints are advisory, so failures are ignored.
+     */
+    void advise(std::size_t offset, std::size_t length, FileAdvice advice) const
+    {
+        using Advice = std::underlying_type<FileAdvice>::type;
+        raw_posix::posix_fadvise(
+            m_fd,
+            static_cast<off_t>(offset),
+            static_cast<off_t>(length),
+            static_cast<Advice>(advice)
+        );
+    }
+
     /**
      * Returns this File's posix file descriptor.
      */
@@ -274,6 +390,27 @@ class MemoryMapping {
         return m_virtual_base != MAP_FAILED;
     }
 
+    /**
+     * Returns the width of this mapping in bytes.
+     */
+    std::size_t size() const
+    {
+        return m_map_span;
+    }
+
+    /**
+     * Returns a pointer to the start of this mapping for ordinary memory
+     * reads, or nullptr if the mapping does not exist.
+     *
+     * Unlike access_memory(), the returned pointer is not volatile. It is
+     * intended for mappings of regular files, whose contents do not change
+     * underneath the program, so the compiler may cache and vectorize reads.
+     */
+    const void* data() const
+    {
+        return m_virtual_base == MAP_FAILED ? nullptr : m_virtual_base;
+    }
+
     /**
      * Returns a pointer to the virtual address corresponding to the physical
      * memory location that is offset from the mapping base by the given offset.